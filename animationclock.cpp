@@ -0,0 +1,24 @@
+#include "animationclock.h"
+
+AnimationClock::AnimationClock(QObject* parent) :
+    QObject(parent)
+{
+}
+
+void AnimationClock::advance(qint64 time)
+{
+    _time = qMax(_time, time);
+    _tickCount++;
+
+    emit ticked(_time);
+}
+
+int AnimationClock::frameAt(qint64 elapsed, int interval, int frameCount)
+{
+    if (elapsed < 0 || interval <= 0 || frameCount <= 0)
+    {
+        return 0;
+    }
+
+    return static_cast<int>((elapsed / interval) % frameCount);
+}
@@ -0,0 +1,65 @@
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+#include <QObject>
+
+/*!
+ * \brief The AnimationClock class ticks every sprite animation once per frame, so animations
+ * need no timers of their own. Animations remember when they started and work out which image
+ * to show from how much time has passed since, which keeps them in step however unevenly the
+ * frames arrive.
+ */
+class AnimationClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Constructs a clock at time 0.
+     */
+    explicit AnimationClock(QObject* parent = nullptr);
+
+    /*!
+     * \brief Gets the time (in milliseconds) of the last tick
+     */
+    inline qint64 time() const
+    {
+        return _time;
+    }
+
+    /*!
+     * \brief Gets the number of ticks so far
+     */
+    inline qint64 tickCount() const
+    {
+        return _tickCount;
+    }
+
+    /*!
+     * \brief Moves the clock forward and ticks every animation.
+     * \param time the current time (in milliseconds), which never goes backwards
+     */
+    void advance(qint64 time);
+
+    /*!
+     * \brief Works out which image of a looping animation to show.
+     * \param elapsed the time (in milliseconds) since the animation started
+     * \param interval the time (in milliseconds) each image is shown for
+     * \param frameCount the number of images in the animation
+     * \return the index of the image
+     */
+    static int frameAt(qint64 elapsed, int interval, int frameCount);
+
+signals:
+    /*!
+     * \brief Emitted once per frame for animations to update their image.
+     * \param time the current time (in milliseconds)
+     */
+    void ticked(qint64 time);
+
+private:
+    qint64 _time = 0;
+    qint64 _tickCount = 0;
+};
+
+#endif // ANIMATIONCLOCK_H
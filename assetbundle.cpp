@@ -0,0 +1,254 @@
+#include "assetbundle.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QStringList>
+
+namespace
+{
+    /*!
+     * \brief The first four bytes of a bundle, "CHAB" in little-endian order
+     */
+    const quint32 BUNDLE_MAGIC = 0x42414843;
+    const quint8 BUNDLE_VERSION = 1;
+
+    /*!
+     * \brief The order the pixels of this machine are stored in
+     */
+    const quint8 PIXEL_BYTE_ORDER = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? 0 : 1;
+
+    /*!
+     * \brief Every entry starts on a boundary this size, which keeps scanlines aligned for
+     * the raster paint engine
+     */
+    const int ENTRY_ALIGNMENT = 64;
+
+    int aligned(int offset)
+    {
+        return (offset + ENTRY_ALIGNMENT - 1) / ENTRY_ALIGNMENT * ENTRY_ALIGNMENT;
+    }
+}
+
+AssetBundle& AssetBundle::instance()
+{
+    static AssetBundle bundle;
+    return bundle;
+}
+
+bool AssetBundle::pack(QString const& path, QHash<QString, QImage> const& images,
+                       QHash<QString, MapData> const& maps)
+{
+    // Sort the entries so that packing the same assets always writes the same file
+    QStringList imagePaths = images.keys();
+    QStringList mapPaths = maps.keys();
+    imagePaths.sort();
+    mapPaths.sort();
+
+    QVector<QString> names;
+    QVector<Entry> entries;
+    QVector<QByteArray> payloads;
+
+    for (QString const& imagePath : imagePaths)
+    {
+        QImage const image = images[imagePath].convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        if (image.isNull())
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.kind = ImageEntry;
+        entry.width = static_cast<quint32>(image.width());
+        entry.height = static_cast<quint32>(image.height());
+        entry.bytesPerLine = static_cast<quint32>(image.bytesPerLine());
+
+        names.append(imagePath);
+        entries.append(entry);
+        payloads.append(QByteArray(reinterpret_cast<char const*>(image.constBits()),
+                                   static_cast<int>(image.sizeInBytes())));
+    }
+
+    for (QString const& mapPath : mapPaths)
+    {
+        Entry entry;
+        entry.kind = MapEntry;
+
+        names.append(mapPath);
+        entries.append(entry);
+        payloads.append(maps[mapPath].toBinary());
+    }
+
+    // The index is the same size whatever the offsets are, so lay out the data after a first pass
+    auto writeIndex = [&](QByteArray& data)
+    {
+        BinaryWriter writer(data);
+        writer.writeUInt32(BUNDLE_MAGIC);
+        writer.writeUInt8(BUNDLE_VERSION);
+        writer.writeUInt8(PIXEL_BYTE_ORDER);
+        writer.writeUInt32(static_cast<quint32>(entries.size()));
+
+        for (int i = 0; i < entries.size(); i++)
+        {
+            writer.writeUInt8(entries[i].kind);
+            writer.writeString(names[i]);
+            writer.writeUInt32(entries[i].offset);
+            writer.writeUInt32(entries[i].size);
+            writer.writeUInt32(entries[i].width);
+            writer.writeUInt32(entries[i].height);
+            writer.writeUInt32(entries[i].bytesPerLine);
+        }
+    };
+
+    QByteArray header;
+    writeIndex(header);
+
+    qint64 offset = aligned(header.size());
+    for (int i = 0; i < entries.size(); i++)
+    {
+        entries[i].offset = static_cast<quint32>(offset);
+        entries[i].size = static_cast<quint32>(payloads[i].size());
+        offset = aligned(static_cast<int>(offset + payloads[i].size()));
+
+        if (offset > 0x7fffffff)
+        {
+            qWarning() << "Assets do not fit in one bundle";
+            return false;
+        }
+    }
+
+    header.clear();
+    writeIndex(header);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write asset bundle" << path;
+        return false;
+    }
+
+    file.write(header);
+    for (int i = 0; i < entries.size(); i++)
+    {
+        file.write(QByteArray(static_cast<int>(entries[i].offset - file.pos()), '\0'));
+        file.write(payloads[i]);
+    }
+
+    return file.commit();
+}
+
+bool AssetBundle::open(QString const& path)
+{
+    close();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly) || _file.size() > 0x7fffffff)
+    {
+        qWarning() << "Could not open asset bundle" << path;
+        close();
+        return false;
+    }
+
+    _data = _file.map(0, _file.size());
+    if (_data == nullptr)
+    {
+        qWarning() << "Could not map asset bundle" << path;
+        close();
+        return false;
+    }
+
+    QByteArray const data = QByteArray::fromRawData(reinterpret_cast<char const*>(_data),
+                                                    static_cast<int>(_file.size()));
+    BinaryReader reader(data);
+
+    quint32 magic = reader.readUInt32();
+    quint8 version = reader.readUInt8();
+    quint8 byteOrder = reader.readUInt8();
+    quint32 count = reader.readUInt32();
+    if (!reader.ok() || magic != BUNDLE_MAGIC || version != BUNDLE_VERSION || byteOrder != PIXEL_BYTE_ORDER)
+    {
+        qWarning() << "Asset bundle" << path << "was not packed for this version or machine";
+        close();
+        return false;
+    }
+
+    for (quint32 i = 0; i < count && reader.ok(); i++)
+    {
+        Entry entry;
+        entry.kind = static_cast<EntryKind>(reader.readUInt8());
+        QString name = reader.readString();
+        entry.offset = reader.readUInt32();
+        entry.size = reader.readUInt32();
+        entry.width = reader.readUInt32();
+        entry.height = reader.readUInt32();
+        entry.bytesPerLine = reader.readUInt32();
+
+        // Check every entry against the file up front, so that views over it can never overrun
+        bool valid = static_cast<qint64>(entry.offset) + entry.size <= data.size();
+        if (entry.kind == ImageEntry)
+        {
+            valid = valid && entry.offset % 4 == 0
+                    && entry.bytesPerLine >= static_cast<quint64>(entry.width) * 4
+                    && static_cast<quint64>(entry.bytesPerLine) * entry.height <= entry.size;
+        }
+        else if (entry.kind != MapEntry)
+        {
+            valid = false;
+        }
+
+        if (!reader.ok() || !valid)
+        {
+            qWarning() << "Asset bundle" << path << "is damaged at" << name;
+            close();
+            return false;
+        }
+
+        _entries.insert(name, entry);
+    }
+
+    qDebug() << "Mapped" << _entries.size() << "assets from" << path << "in"
+             << timer.nsecsElapsed() / 1000 << "us," << _file.size() / 1024 << "KiB";
+    return true;
+}
+
+void AssetBundle::close()
+{
+    if (_data != nullptr)
+    {
+        _file.unmap(_data);
+        _data = nullptr;
+    }
+
+    _file.close();
+    _entries.clear();
+}
+
+QImage AssetBundle::image(QString const& path) const
+{
+    auto it = _entries.constFind(path);
+    if (it == _entries.constEnd() || it->kind != ImageEntry)
+    {
+        return QImage();
+    }
+
+    // Constructed over const pixels, the image never writes to the mapping
+    uchar const* pixels = _data + it->offset;
+    return QImage(pixels, static_cast<int>(it->width), static_cast<int>(it->height),
+                  static_cast<int>(it->bytesPerLine), QImage::Format_ARGB32_Premultiplied);
+}
+
+bool AssetBundle::map(QString const& path, MapData& map) const
+{
+    auto it = _entries.constFind(path);
+    if (it == _entries.constEnd() || it->kind != MapEntry)
+    {
+        return false;
+    }
+
+    QByteArray const data = QByteArray::fromRawData(reinterpret_cast<char const*>(_data + it->offset),
+                                                    static_cast<int>(it->size));
+    return MapData::fromBinary(data, map);
+}
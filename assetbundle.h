@@ -0,0 +1,125 @@
+#ifndef ASSETBUNDLE_H
+#define ASSETBUNDLE_H
+
+#include "mapdata.h"
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QString>
+
+/*!
+ * \brief The AssetBundle class reads a single file holding every texture already decoded to
+ * premultiplied ARGB, together with every map in binary form, behind an index of where each one
+ * lies. The file is mapped into memory rather than read, and images are handed out as views over
+ * the mapped pixels, so nothing is decoded or copied at startup and every instance of the game on
+ * the same machine shares the same pages.
+ *
+ * A bundle is laid out as a header, the index, and then the data of each entry:
+ *
+ *     header  magic "CHAB", version, byte order mark, entry count
+ *     index   per entry: kind, name, offset, size, width, height, bytes per line
+ *     data    each entry starts on a 64 byte boundary
+ *
+ * Header and index fields are little-endian, like the rest of the binary formats. Pixels are
+ * stored in the byte order of the machine that packed them, which the byte order mark records,
+ * since that is the only order they can be viewed in without converting them.
+ */
+class AssetBundle
+{
+public:
+    /*!
+     * \brief Returns the bundle shared by the whole process.
+     */
+    static AssetBundle& instance();
+
+    /*!
+     * \brief Writes a bundle.
+     * \param path the path of the file to write
+     * \param images the images to pack, by the resource path they are looked up with
+     * \param maps the maps to pack, by the resource path they are looked up with
+     * \return whether or not the file was able to be written
+     */
+    static bool pack(QString const& path, QHash<QString, QImage> const& images,
+                     QHash<QString, MapData> const& maps);
+
+    /*!
+     * \brief Maps a bundle into memory and reads its index, replacing any bundle opened before.
+     * Images handed out by a bundle point into its mapped file, so a bundle must stay open for as
+     * long as any of them are in use.
+     * \param path the path of the bundle
+     * \return whether or not the bundle was able to be opened
+     */
+    bool open(QString const& path);
+
+    /*!
+     * \brief Unmaps the bundle.
+     */
+    void close();
+
+    inline bool isOpen() const
+    {
+        return _data != nullptr;
+    }
+
+    /*!
+     * \brief Returns whether the bundle holds an image.
+     * \param path the resource path of the image
+     */
+    inline bool hasImage(QString const& path) const
+    {
+        auto it = _entries.constFind(path);
+        return it != _entries.constEnd() && it->kind == ImageEntry;
+    }
+
+    /*!
+     * \brief Returns an image straight over the mapped pixels. The image is read only; painting on
+     * it makes a private copy first.
+     * \param path the resource path of the image, such as ":/images/bullet.png"
+     * \return the image, or a null image if the bundle does not hold it
+     */
+    QImage image(QString const& path) const;
+
+    /*!
+     * \brief Reads a map held by the bundle.
+     * \param path the resource path of the map, such as ":/maps/arena.map"
+     * \param map the resulting map, if the bundle holds it
+     * \return whether or not the map was able to be read
+     */
+    bool map(QString const& path, MapData& map) const;
+
+    /*!
+     * \brief Returns the number of bytes mapped.
+     */
+    inline qint64 size() const
+    {
+        return _data != nullptr ? _file.size() : 0;
+    }
+
+private:
+    enum EntryKind : quint8
+    {
+        ImageEntry,
+        MapEntry
+    };
+
+    struct Entry
+    {
+        EntryKind kind = ImageEntry;
+        quint32 offset = 0;
+        quint32 size = 0;
+        quint32 width = 0;
+        quint32 height = 0;
+        quint32 bytesPerLine = 0;
+    };
+
+    AssetBundle() = default;
+    AssetBundle(AssetBundle const&) = delete;
+    AssetBundle& operator=(AssetBundle const&) = delete;
+
+    QFile _file;
+    uchar* _data = nullptr;
+    QHash<QString, Entry> _entries;
+};
+
+#endif // ASSETBUNDLE_H
@@ -0,0 +1,6 @@
+# Shared by every benchmark under bench/, which build against the game's sources directly
+QT       += testlib
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/..
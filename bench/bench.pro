@@ -0,0 +1,11 @@
+# Each benchmark is its own executable. They are not part of "make check", since their
+#  results only mean something on a quiet machine; run them one at a time instead.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    broadphase \
+    codec \
+    idle \
+    mapload \
+    paint \
+    projectiles
@@ -0,0 +1,176 @@
+#include "spatialgrid.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+
+namespace
+{
+    const int PLAYER_COUNT = 8;
+    const int HEALTH_KIT_COUNT = 3;
+
+    /*!
+     * \brief How far a bullet sweeps in one tick, and how far a player may move.
+     */
+    const qreal BULLET_SWEEP = BULLET_SPEED * SIMULATION_STEP + BULLET_LENGTH;
+    const qreal PLAYER_STEP = PLAYER_MAX_VELOCITY;
+
+    /*!
+     * \brief The bounding boxes of everything in a game, moved a little every tick.
+     */
+    struct Scene
+    {
+        QVector<QRectF> players;
+        QVector<QRectF> healthKits;
+        QVector<QRectF> bullets;
+        QRandomGenerator random { 7 };
+
+        explicit Scene(int bulletCount)
+        {
+            for (int i = 0; i < PLAYER_COUNT; i++)
+            {
+                players.append(QRectF(randomPoint(), QSizeF(PLAYER_SIZE, PLAYER_SIZE)));
+            }
+            for (int i = 0; i < HEALTH_KIT_COUNT; i++)
+            {
+                healthKits.append(QRectF(randomPoint(), QSizeF(PLAYER_SIZE, PLAYER_SIZE)));
+            }
+            for (int i = 0; i < bulletCount; i++)
+            {
+                bullets.append(QRectF(randomPoint(), QSizeF(BULLET_SWEEP, BULLET_SWEEP)));
+            }
+        }
+
+        QPointF randomPoint()
+        {
+            return QPointF(random.bounded(MAP_WIDTH - PLAYER_SIZE), random.bounded(MAP_HEIGHT - PLAYER_SIZE));
+        }
+
+        void movePlayers()
+        {
+            for (QRectF& player : players)
+            {
+                QPointF step(random.bounded(2 * PLAYER_STEP) - PLAYER_STEP, random.bounded(2 * PLAYER_STEP) - PLAYER_STEP);
+                player.translate(step);
+                player.moveTo(qBound(0.0, player.x(), MAP_WIDTH - PLAYER_SIZE), qBound(0.0, player.y(), MAP_HEIGHT - PLAYER_SIZE));
+            }
+        }
+    };
+}
+
+/*!
+ * \brief The BroadphaseBenchmark class measures the collision queries of one tick as the number
+ * of bullets grows: every player looks for players and health kits it touches, and every bullet
+ * looks for players in its path. The grid is compared against testing every pair.
+ */
+class BroadphaseBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void gridTick_data();
+    void gridTick();
+    void everyPairTick_data();
+    void everyPairTick();
+
+private:
+    void addRows();
+};
+
+void BroadphaseBenchmark::addRows()
+{
+    QTest::addColumn<int>("bulletCount");
+
+    for (int bulletCount : { 0, 50, 200, 800 })
+    {
+        QTest::addRow("%d bullets", bulletCount) << bulletCount;
+    }
+}
+
+void BroadphaseBenchmark::gridTick_data()
+{
+    addRows();
+}
+
+void BroadphaseBenchmark::gridTick()
+{
+    QFETCH(int, bulletCount);
+
+    Scene scene(bulletCount);
+    SpatialGrid grid;
+    for (int i = 0; i < HEALTH_KIT_COUNT; i++)
+    {
+        grid.update(EntityKind::Pickup, i, scene.healthKits[i]);
+    }
+
+    QVector<quint32> candidates;
+    int touching = 0;
+
+    QBENCHMARK
+    {
+        scene.movePlayers();
+        for (int i = 0; i < PLAYER_COUNT; i++)
+        {
+            grid.update(EntityKind::Player, i, scene.players[i]);
+        }
+
+        for (QRectF const& player : qAsConst(scene.players))
+        {
+            grid.query(EntityKind::Player, player, candidates);
+            touching += candidates.size();
+            grid.query(EntityKind::Pickup, player, candidates);
+            touching += candidates.size();
+        }
+
+        for (QRectF const& bullet : qAsConst(scene.bullets))
+        {
+            grid.query(EntityKind::Player, bullet, candidates);
+            touching += candidates.size();
+        }
+    }
+
+    QVERIFY(touching > 0);
+}
+
+void BroadphaseBenchmark::everyPairTick_data()
+{
+    addRows();
+}
+
+void BroadphaseBenchmark::everyPairTick()
+{
+    QFETCH(int, bulletCount);
+
+    Scene scene(bulletCount);
+    int touching = 0;
+
+    QBENCHMARK
+    {
+        scene.movePlayers();
+
+        for (QRectF const& player : qAsConst(scene.players))
+        {
+            for (QRectF const& other : qAsConst(scene.players))
+            {
+                touching += player.intersects(other);
+            }
+            for (QRectF const& healthKit : qAsConst(scene.healthKits))
+            {
+                touching += player.intersects(healthKit);
+            }
+        }
+
+        for (QRectF const& bullet : qAsConst(scene.bullets))
+        {
+            for (QRectF const& player : qAsConst(scene.players))
+            {
+                touching += bullet.intersects(player);
+            }
+        }
+    }
+
+    QVERIFY(touching > 0);
+}
+
+QTEST_GUILESS_MAIN(BroadphaseBenchmark)
+
+#include "bench_broadphase.moc"
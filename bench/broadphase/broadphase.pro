@@ -0,0 +1,13 @@
+include(../bench.pri)
+
+QT       -= gui
+
+TARGET = bench_broadphase
+
+SOURCES += \
+    ../../spatialgrid.cpp \
+    bench_broadphase.cpp
+
+HEADERS += \
+    ../../settings.h \
+    ../../spatialgrid.h
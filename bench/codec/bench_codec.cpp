@@ -0,0 +1,129 @@
+#include "networkbase.h"
+
+#include <QtTest>
+
+Q_DECLARE_METATYPE(NetworkBase::Message)
+Q_DECLARE_METATYPE(NetworkBase::WireFormat)
+
+namespace
+{
+    /*!
+     * \brief Returns one message of each type that is sent during a game, filled in
+     * the way a game fills them in.
+     */
+    QVector<QPair<char const*, NetworkBase::Message>> sampleMessages()
+    {
+        QVector<QPair<char const*, NetworkBase::Message>> messages;
+        NetworkBase::Message message;
+
+        message.type = NetworkBase::POSITION_UPDATE;
+        message.color = PlayerColor::Magenta;
+        message.position = QPointF(612.25, 287.5);
+        message.inputSequence = 48213;
+        messages.append({ "position", message });
+
+        message = NetworkBase::Message();
+        message.type = NetworkBase::BULLET_SHOT;
+        message.color = PlayerColor::Blue;
+        message.position = QPointF(431.5, 108.75);
+        message.angle = 213.4;
+        messages.append({ "bullet", message });
+
+        message = NetworkBase::Message();
+        message.type = NetworkBase::HEALTH_UPDATE;
+        message.color = PlayerColor::Green;
+        message.health = 70;
+        message.hasCrown = true;
+        messages.append({ "health", message });
+
+        message = NetworkBase::Message();
+        message.type = NetworkBase::JOIN_REQUEST;
+        message.color = PlayerColor::Cyan;
+        message.username = QStringLiteral("Hunter42");
+        message.protocolVersion = BINARY_PROTOCOL_VERSION;
+        message.datagramPort = 52311;
+        messages.append({ "join", message });
+
+        message = NetworkBase::Message();
+        message.type = NetworkBase::CHAT_MESSAGE;
+        message.color = PlayerColor::White;
+        message.username = QStringLiteral("Hunter42");
+        message.body = QStringLiteral("Who has the crown?");
+        messages.append({ "chat", message });
+
+        return messages;
+    }
+
+    void addRows()
+    {
+        QTest::addColumn<NetworkBase::Message>("message");
+        QTest::addColumn<NetworkBase::WireFormat>("format");
+
+        for (auto const& sample : sampleMessages())
+        {
+            QTest::addRow("%s json", sample.first) << sample.second << NetworkBase::JSON_FORMAT;
+            QTest::addRow("%s binary", sample.first) << sample.second << NetworkBase::BINARY_FORMAT;
+        }
+    }
+}
+
+/*!
+ * \brief The CodecBenchmark class compares the size of, and the time taken to encode and
+ * decode, each kind of message in both wire formats.
+ */
+class CodecBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encode_data();
+    void encode();
+    void decode_data();
+    void decode();
+};
+
+void CodecBenchmark::encode_data()
+{
+    addRows();
+}
+
+void CodecBenchmark::encode()
+{
+    QFETCH(NetworkBase::Message, message);
+    QFETCH(NetworkBase::WireFormat, format);
+
+    QByteArray payload;
+    QBENCHMARK
+    {
+        payload = NetworkBase::encode(message, format);
+    }
+
+    // A frame adds a 4 byte length prefix to every payload
+    qInfo("%d bytes per message", payload.size() + static_cast<int>(sizeof(quint32)));
+}
+
+void CodecBenchmark::decode_data()
+{
+    addRows();
+}
+
+void CodecBenchmark::decode()
+{
+    QFETCH(NetworkBase::Message, message);
+    QFETCH(NetworkBase::WireFormat, format);
+
+    QByteArray const payload = NetworkBase::encode(message, format);
+    NetworkBase::Message decoded;
+
+    QBENCHMARK
+    {
+        QVERIFY(NetworkBase::decode(payload, decoded));
+    }
+
+    QCOMPARE(decoded.type, message.type);
+    QCOMPARE(decoded.color, message.color);
+}
+
+QTEST_GUILESS_MAIN(CodecBenchmark)
+
+#include "bench_codec.moc"
@@ -0,0 +1,22 @@
+include(../bench.pri)
+
+QT       -= gui
+QT       += network
+
+TARGET = bench_codec
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../mapdata.cpp \
+    ../../networkbase.cpp \
+    ../../playercolor.cpp \
+    ../../worldsnapshot.cpp \
+    bench_codec.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../mapdata.h \
+    ../../networkbase.h \
+    ../../playercolor.h \
+    ../../settings.h \
+    ../../worldsnapshot.h
@@ -0,0 +1,96 @@
+#include "mapscene.h"
+#include "processusage.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QtTest>
+
+namespace
+{
+    /*!
+     * \brief How long the scene is left idle for each measurement, in milliseconds.
+     */
+    const int IDLE_DURATION = 5000;
+
+    /*!
+     * \brief TimerCounter counts every timer event delivered in the application, each of
+     * which is a wakeup of the event loop.
+     */
+    class TimerCounter : public QObject
+    {
+    public:
+        int count = 0;
+
+    protected:
+        bool eventFilter(QObject* watched, QEvent* event) override
+        {
+            if (event->type() == QEvent::Timer)
+            {
+                count++;
+            }
+            return QObject::eventFilter(watched, event);
+        }
+    };
+}
+
+/*!
+ * \brief The IdleBenchmark class leaves a scene running with nobody playing, and measures
+ * how much CPU time it uses and how often timers wake it up.
+ */
+class IdleBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void idleScene_data();
+    void idleScene();
+};
+
+void IdleBenchmark::idleScene_data()
+{
+    QTest::addColumn<bool>("overlay");
+
+    QTest::newRow("players and health kits") << false;
+    QTest::newRow("with game start overlay") << true;
+}
+
+void IdleBenchmark::idleScene()
+{
+    QFETCH(bool, overlay);
+
+    MapScene scene;
+    scene.healthSpawner();
+    if (overlay)
+    {
+        scene.runGameStartOverlay();
+    }
+
+    TimerCounter timers;
+    qApp->installEventFilter(&timers);
+
+    qint64 cpuBefore = cpuTime();
+    QElapsedTimer wall;
+    wall.start();
+
+    // A plain event loop, since QTest::qWait polls and would add wakeups of its own
+    QEventLoop loop;
+    QTimer::singleShot(IDLE_DURATION, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    qint64 cpuUsed = cpuTime() - cpuBefore;
+    qreal seconds = wall.elapsed() / 1000.0;
+    qApp->removeEventFilter(&timers);
+
+    if (cpuBefore < 0)
+    {
+        QSKIP("CPU time cannot be measured on this platform");
+    }
+
+    qInfo("%.1f ms of CPU per second, %.1f%% of one core", cpuUsed / seconds, cpuUsed / seconds / 10);
+    qInfo("%.1f timer wakeups per second", timers.count / seconds);
+}
+
+QTEST_MAIN(IdleBenchmark)
+
+#include "bench_idle.moc"
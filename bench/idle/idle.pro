@@ -0,0 +1,15 @@
+include(../bench.pri)
+
+# The scene needs everything the game draws with, so the benchmark builds all of the game but main()
+QT       += network concurrent widgets
+
+TARGET = bench_idle
+
+include(../../game.pri)
+
+SOURCES += \
+    ../../processusage.cpp \
+    bench_idle.cpp
+
+HEADERS += \
+    ../../processusage.h
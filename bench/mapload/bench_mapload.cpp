@@ -0,0 +1,116 @@
+#include "gameworld.h"
+#include "mapdata.h"
+
+#include <QFile>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace
+{
+    const QString ARENA_PATH = QStringLiteral(":/maps/arena.map");
+}
+
+/*!
+ * \brief The MapLoadBenchmark class measures loading the arena from its text and binary files,
+ * and baking its walls for collision, which together are what loading a map costs.
+ */
+class MapLoadBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void load_data();
+    void load();
+    void bake();
+    void loadAndBake_data();
+    void loadAndBake();
+
+private:
+    void addRows();
+
+    QTemporaryDir _directory;
+    MapData _arena;
+};
+
+void MapLoadBenchmark::initTestCase()
+{
+    // Every load logs how long it took, which would only slow down the loads being timed
+    QLoggingCategory::setFilterRules(QStringLiteral("default.debug=false"));
+
+    QVERIFY(MapData::load(ARENA_PATH, _arena));
+    QVERIFY(_directory.isValid());
+
+    // Both forms are loaded from real files, the way a map is loaded from disk
+    QFile text(_directory.filePath("arena.map"));
+    QVERIFY(text.open(QIODevice::WriteOnly));
+    text.write(_arena.toText().toUtf8());
+    text.close();
+
+    QFile binary(_directory.filePath("arena-binary.map"));
+    QVERIFY(binary.open(QIODevice::WriteOnly));
+    binary.write(_arena.toBinary());
+    binary.close();
+}
+
+void MapLoadBenchmark::addRows()
+{
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("text") << _directory.filePath("arena.map");
+    QTest::newRow("binary") << _directory.filePath("arena-binary.map");
+}
+
+void MapLoadBenchmark::load_data()
+{
+    addRows();
+}
+
+void MapLoadBenchmark::load()
+{
+    QFETCH(QString, path);
+
+    MapData map;
+    QBENCHMARK
+    {
+        QVERIFY(MapData::load(path, map));
+    }
+
+    QCOMPARE(map.walls.size(), _arena.walls.size());
+    QCOMPARE(map.spawns, _arena.spawns);
+}
+
+void MapLoadBenchmark::bake()
+{
+    GameWorld world;
+    QBENCHMARK
+    {
+        world.loadMap(_arena);
+    }
+
+    QCOMPARE(world.walls().size(), _arena.walls.size());
+}
+
+void MapLoadBenchmark::loadAndBake_data()
+{
+    addRows();
+}
+
+void MapLoadBenchmark::loadAndBake()
+{
+    QFETCH(QString, path);
+
+    GameWorld world;
+    QBENCHMARK
+    {
+        MapData map;
+        QVERIFY(MapData::load(path, map));
+        world.loadMap(map);
+    }
+}
+
+QTEST_GUILESS_MAIN(MapLoadBenchmark)
+
+#include "bench_mapload.moc"
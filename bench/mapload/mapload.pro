@@ -0,0 +1,32 @@
+include(../bench.pri)
+
+QT       -= gui
+
+TARGET = bench_mapload
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../gameworld.cpp \
+    ../../geometry.cpp \
+    ../../mapdata.cpp \
+    ../../playercolor.cpp \
+    ../../projectilesystem.cpp \
+    ../../spatialgrid.cpp \
+    ../../timerwheel.cpp \
+    ../../wallfield.cpp \
+    bench_mapload.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../gameworld.h \
+    ../../geometry.h \
+    ../../mapdata.h \
+    ../../playercolor.h \
+    ../../projectilesystem.h \
+    ../../settings.h \
+    ../../spatialgrid.h \
+    ../../timerwheel.h \
+    ../../wallfield.h
+
+RESOURCES += \
+    ../../maps.qrc
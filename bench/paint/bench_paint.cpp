@@ -0,0 +1,62 @@
+#include "mapscene.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QtTest>
+
+/*!
+ * \brief The PaintBenchmark class measures how long drawing one whole frame of the arena takes,
+ * with all 8 players, a wave of health kits and, optionally, a full screen overlay.
+ */
+class PaintBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fullFrame_data();
+    void fullFrame();
+};
+
+void PaintBenchmark::fullFrame_data()
+{
+    QTest::addColumn<QString>("overlay");
+
+    QTest::newRow("no overlay") << QString();
+    QTest::newRow("game start overlay") << QStringLiteral("gameStart");
+    QTest::newRow("respawn overlay") << QStringLiteral("respawn");
+}
+
+void PaintBenchmark::fullFrame()
+{
+    QFETCH(QString, overlay);
+
+    MapScene scene;
+    scene.healthSpawner();
+    if (overlay == QLatin1String("gameStart"))
+    {
+        scene.runGameStartOverlay();
+    }
+    else if (overlay == QLatin1String("respawn"))
+    {
+        scene.onPlayerDied(scene.myPlayer()->color(), 0);
+    }
+
+    // Create the items for the health kits just spawned
+    scene.onFrame();
+    QCOMPARE(scene.world().players().size(), DEFAULT_MAX_PLAYERS);
+    QVERIFY(!scene.world().healthKits().isEmpty());
+
+    // Draw into the format of the raster backing store, the way a view repaints the whole scene
+    QRectF const area = scene.sceneRect();
+    QImage frame(area.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK
+    {
+        QPainter painter(&frame);
+        scene.render(&painter, QRectF(frame.rect()), area);
+    }
+}
+
+QTEST_MAIN(PaintBenchmark)
+
+#include "bench_paint.moc"
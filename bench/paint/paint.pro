@@ -0,0 +1,11 @@
+include(../bench.pri)
+
+# The scene needs everything the game draws with, so the benchmark builds all of the game but main()
+QT       += network concurrent widgets
+
+TARGET = bench_paint
+
+include(../../game.pri)
+
+SOURCES += \
+    bench_paint.cpp
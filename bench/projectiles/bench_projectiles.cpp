@@ -0,0 +1,108 @@
+#include "projectilesystem.h"
+
+#include <QElapsedTimer>
+#include <QtTest>
+
+namespace
+{
+    const qreal STEP_TRAVEL = BULLET_SPEED * SIMULATION_STEP;
+
+    /*!
+     * \brief How many steps the bullets-per-millisecond figure is averaged over.
+     */
+    const int MEASURED_STEPS = 1000;
+
+    void fire(ProjectileSystem& bullets, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            bullets.spawn(static_cast<PlayerColor>(i % 8), QPointF(i % 1200, i % 600), i * 37.0);
+        }
+    }
+}
+
+/*!
+ * \brief The ProjectilesBenchmark class measures how many bullets ProjectileSystem moves per
+ * millisecond, and what sustained fire costs once the free list is warm.
+ */
+class ProjectilesBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void advance_data();
+    void advance();
+    void sustainedFire_data();
+    void sustainedFire();
+};
+
+void ProjectilesBenchmark::advance_data()
+{
+    QTest::addColumn<int>("bulletCount");
+
+    for (int bulletCount : { 100, 1000, 10000 })
+    {
+        QTest::addRow("%d bullets", bulletCount) << bulletCount;
+    }
+}
+
+void ProjectilesBenchmark::advance()
+{
+    QFETCH(int, bulletCount);
+
+    ProjectileSystem bullets;
+    fire(bullets, bulletCount);
+
+    QBENCHMARK
+    {
+        bullets.advance(STEP_TRAVEL, SIMULATION_STEP);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < MEASURED_STEPS; i++)
+    {
+        bullets.advance(STEP_TRAVEL, SIMULATION_STEP);
+    }
+    qint64 elapsed = qMax(timer.nsecsElapsed(), qint64(1));
+
+    qInfo("%.0f bullets per millisecond", qreal(bulletCount) * MEASURED_STEPS * 1000000 / elapsed);
+}
+
+void ProjectilesBenchmark::sustainedFire_data()
+{
+    advance_data();
+}
+
+void ProjectilesBenchmark::sustainedFire()
+{
+    QFETCH(int, bulletCount);
+
+    ProjectileSystem bullets;
+    fire(bullets, bulletCount);
+
+    // Every step, a tenth of the bullets hit something and as many are fired
+    int const turnover = qMax(1, bulletCount / 10);
+    int next = 0;
+
+    QBENCHMARK
+    {
+        for (int removed = 0; removed < turnover; next = (next + 7) % bullets.capacity())
+        {
+            if (bullets.isAlive(next))
+            {
+                bullets.remove(next);
+                removed++;
+            }
+        }
+        fire(bullets, turnover);
+        bullets.advance(STEP_TRAVEL, SIMULATION_STEP);
+    }
+
+    // The freed slots were reused, so sustained fire never grew the arrays
+    QCOMPARE(bullets.capacity(), bulletCount);
+}
+
+QTEST_GUILESS_MAIN(ProjectilesBenchmark)
+
+#include "bench_projectiles.moc"
@@ -0,0 +1,15 @@
+include(../bench.pri)
+
+QT       -= gui
+
+TARGET = bench_projectiles
+
+SOURCES += \
+    ../../playercolor.cpp \
+    ../../projectilesystem.cpp \
+    bench_projectiles.cpp
+
+HEADERS += \
+    ../../playercolor.h \
+    ../../projectilesystem.h \
+    ../../settings.h
@@ -0,0 +1,151 @@
+#include "binarystream.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+BinaryWriter::BinaryWriter(QByteArray& data)
+    : _data(data)
+{
+
+}
+
+void BinaryWriter::writeUInt8(quint8 value)
+{
+    _data.append(static_cast<char>(value));
+}
+
+void BinaryWriter::writeInt16(qint16 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    _data.append(bytes, sizeof(bytes));
+}
+
+void BinaryWriter::writeUInt16(quint16 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    _data.append(bytes, sizeof(bytes));
+}
+
+void BinaryWriter::writeInt32(qint32 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    _data.append(bytes, sizeof(bytes));
+}
+
+void BinaryWriter::writeUInt32(quint32 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    _data.append(bytes, sizeof(bytes));
+}
+
+void BinaryWriter::writeFloat(qreal value)
+{
+    float single = static_cast<float>(value);
+    quint32 bits;
+    std::memcpy(&bits, &single, sizeof(bits));
+
+    writeUInt32(bits);
+}
+
+void BinaryWriter::writeString(QString const& value)
+{
+    QByteArray const utf8 = value.toUtf8().left(0xFFFF);
+    writeUInt16(static_cast<quint16>(utf8.size()));
+    _data.append(utf8);
+}
+
+BinaryReader::BinaryReader(QByteArray const& data, int offset)
+    : _data(data)
+    , _offset(offset)
+{
+
+}
+
+bool BinaryReader::has(int count)
+{
+    _ok = _ok && (_offset + count <= _data.size());
+    return _ok;
+}
+
+quint8 BinaryReader::readUInt8()
+{
+    if (!has(1))
+    {
+        return 0;
+    }
+
+    return static_cast<quint8>(_data[_offset++]);
+}
+
+qint16 BinaryReader::readInt16()
+{
+    return static_cast<qint16>(readUInt16());
+}
+
+quint16 BinaryReader::readUInt16()
+{
+    if (!has(2))
+    {
+        return 0;
+    }
+
+    quint16 value = qFromLittleEndian<quint16>(_data.constData() + _offset);
+    _offset += 2;
+    return value;
+}
+
+qint32 BinaryReader::readInt32()
+{
+    return static_cast<qint32>(readUInt32());
+}
+
+quint32 BinaryReader::readUInt32()
+{
+    if (!has(4))
+    {
+        return 0;
+    }
+
+    quint32 value = qFromLittleEndian<quint32>(_data.constData() + _offset);
+    _offset += 4;
+    return value;
+}
+
+qreal BinaryReader::readFloat()
+{
+    quint32 bits = readUInt32();
+
+    float single;
+    std::memcpy(&single, &bits, sizeof(single));
+    return static_cast<qreal>(single);
+}
+
+QString BinaryReader::readString()
+{
+    int length = readUInt16();
+    if (!has(length))
+    {
+        return QString();
+    }
+
+    QString value = QString::fromUtf8(_data.constData() + _offset, length);
+    _offset += length;
+    return value;
+}
+
+QByteArray BinaryReader::readBytes(int count)
+{
+    if (!has(count))
+    {
+        return QByteArray();
+    }
+
+    QByteArray value = _data.mid(_offset, count);
+    _offset += count;
+    return value;
+}
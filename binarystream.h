@@ -0,0 +1,113 @@
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <QByteArray>
+#include <QString>
+
+/*!
+ * \brief BinaryWriter appends fixed-layout, little-endian fields to a byte array.
+ * It is used to build the payloads of the binary wire protocol.
+ */
+class BinaryWriter
+{
+public:
+    /*!
+     * \brief Creates a writer that appends to the provided byte array.
+     * \param data the byte array to append to
+     */
+    explicit BinaryWriter(QByteArray& data);
+
+    void writeUInt8(quint8 value);
+    void writeInt16(qint16 value);
+    void writeUInt16(quint16 value);
+    void writeInt32(qint32 value);
+    void writeUInt32(quint32 value);
+
+    /*!
+     * \brief Writes a value as a single precision float.
+     * \param value the value to write
+     */
+    void writeFloat(qreal value);
+
+    /*!
+     * \brief Writes a string as UTF-8 preceded by its 16 bit length.
+     * Strings longer than 65535 bytes are truncated.
+     * \param value the string to write
+     */
+    void writeString(QString const& value);
+
+private:
+    QByteArray& _data;
+};
+
+/*!
+ * \brief BinaryReader reads fixed-layout, little-endian fields from a byte array in order.
+ * Reading past the end of the data marks the reader as failed and returns zero values,
+ * so a payload can be read in full and validated once at the end with ok().
+ */
+class BinaryReader
+{
+public:
+    /*!
+     * \brief Creates a reader over the provided byte array.
+     * \param data the byte array to read from, which must outlive the reader
+     * \param offset the offset of the first byte to read
+     */
+    explicit BinaryReader(QByteArray const& data, int offset = 0);
+
+    /*!
+     * \brief Returns whether every read so far has been within the bounds of the data.
+     * \return whether or not the reader is still valid
+     */
+    inline bool ok() const
+    {
+        return _ok;
+    }
+
+    /*!
+     * \brief Returns whether every byte of the data has been read.
+     * \return whether or not the reader is at the end of the data
+     */
+    inline bool atEnd() const
+    {
+        return _offset >= _data.size();
+    }
+
+    /*!
+     * \brief Returns the offset of the next byte to be read.
+     * \return the current offset
+     */
+    inline int offset() const
+    {
+        return _offset;
+    }
+
+    quint8 readUInt8();
+    qint16 readInt16();
+    quint16 readUInt16();
+    qint32 readInt32();
+    quint32 readUInt32();
+    qreal readFloat();
+    QString readString();
+
+    /*!
+     * \brief Reads a block of raw bytes.
+     * \param count the number of bytes to read
+     * \return the bytes read, or an empty array if fewer bytes are left
+     */
+    QByteArray readBytes(int count);
+
+private:
+    /*!
+     * \brief Checks whether the specified number of bytes are left to be read.
+     * \param count the number of bytes about to be read
+     * \return whether or not the bytes are available
+     */
+    bool has(int count);
+
+    QByteArray const& _data;
+    int _offset;
+    bool _ok = true;
+};
+
+#endif // BINARYSTREAM_H
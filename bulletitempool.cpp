@@ -0,0 +1,40 @@
+#include "bulletitempool.h"
+
+BulletItemPool::BulletItemPool(QGraphicsScene* scene)
+    : _scene(scene)
+{
+
+}
+
+BulletItem* BulletItemPool::acquire()
+{
+    _acquisitions++;
+    _inUse++;
+
+    if (!_free.isEmpty())
+    {
+        _hits++;
+
+        BulletItem* item = _free.takeLast();
+        item->show();
+        return item;
+    }
+
+    _highWaterMark = qMax(_highWaterMark, _inUse);
+
+    BulletItem* item = new BulletItem;
+    _scene->addItem(item);
+    return item;
+}
+
+void BulletItemPool::release(BulletItem* item)
+{
+    if (item == nullptr)
+    {
+        return;
+    }
+
+    item->hide();
+    _free.append(item);
+    _inUse--;
+}
@@ -0,0 +1,75 @@
+#ifndef BULLETITEMPOOL_H
+#define BULLETITEMPOOL_H
+
+#include "bulletitem.h"
+
+#include <QGraphicsScene>
+#include <QVector>
+
+/*!
+ * \brief The BulletItemPool class hands out bullet items for drawing bullets in flight. Items are
+ * created and added to the scene only the first time they are needed. After that they are hidden
+ * when released and shown again when acquired, so bursts of fire neither allocate nor add items
+ * to and remove them from the scene.
+ */
+class BulletItemPool
+{
+public:
+    /*!
+     * \brief Creates an empty pool.
+     * \param scene the scene that every item of the pool is added to, and that owns them
+     */
+    explicit BulletItemPool(QGraphicsScene* scene);
+
+    /*!
+     * \brief Returns a visible bullet item, reusing a released one if there is any.
+     * \return the bullet item
+     */
+    BulletItem* acquire();
+
+    /*!
+     * \brief Hides a bullet item until it is acquired again.
+     * \param item the bullet item
+     */
+    void release(BulletItem* item);
+
+    /*!
+     * \brief Returns the number of items currently acquired.
+     */
+    inline int inUse() const
+    {
+        return _inUse;
+    }
+
+    /*!
+     * \brief Returns the largest number of items ever acquired at once, which is also the
+     * number of items created.
+     */
+    inline int highWaterMark() const
+    {
+        return _highWaterMark;
+    }
+
+    /*!
+     * \brief Returns the fraction (0 to 1) of acquisitions that reused a released item.
+     */
+    inline qreal hitRate() const
+    {
+        return _acquisitions > 0 ? static_cast<qreal>(_hits) / _acquisitions : 0.0;
+    }
+
+private:
+    QGraphicsScene* _scene;
+
+    /*!
+     * \brief Hidden items waiting to be reused
+     */
+    QVector<BulletItem*> _free;
+
+    int _inUse = 0;
+    int _highWaterMark = 0;
+    qint64 _acquisitions = 0;
+    qint64 _hits = 0;
+};
+
+#endif // BULLETITEMPOOL_H
@@ -1,17 +1,17 @@
 #ifndef CROWNITEM_H
 #define CROWNITEM_H
 
-#include "playeritem.h"
+#include "settings.h"
 
 #include <QtDebug>
 #include <QGraphicsItem>
 #include <QObject>
-#include <QGraphicsRectItem>
-#include <QBrush>
+#include <QGraphicsPixmapItem>
 /*!
- * \brief CrownItem class is a collectable item the players can pick up
+ * \brief CrownItem class draws the crown while it waits to be picked up. The GameWorld decides
+ * who picks it up.
  */
-class CrownItem : public QObject, public QGraphicsRectItem
+class CrownItem : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
 public:
@@ -20,24 +20,6 @@ public:
      * \param pointer to parent graphicsitem
      */
     CrownItem(QGraphicsItem * parent = nullptr);
-    /*!
-     * \brief Variable for the width of the crown
-     */
-    int width = 25;
-    /*!
-     * \brief Variable for the height of the crown
-     */
-    int height = 25;
-
-protected:
-    void advance(int phase);
-
-private:
-    /*!
-     * \brief Function to determine collision with player
-     * \return True or false of player collision
-     */
-    bool collidesWithPlayer();
 };
 
 #endif // CROWNITEM_H
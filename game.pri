@@ -0,0 +1,79 @@
+# The game's sources, everything but main(), shared by the game and the benchmarks that build all of it
+SOURCES += \
+    $$PWD/animationclock.cpp \
+    $$PWD/assetbundle.cpp \
+    $$PWD/binarystream.cpp \
+    $$PWD/bulletitem.cpp \
+    $$PWD/bulletitempool.cpp \
+    $$PWD/configdialog.cpp \
+    $$PWD/crownitem.cpp \
+    $$PWD/gamestartoverlayitem.cpp \
+    $$PWD/gameworld.cpp \
+    $$PWD/geometry.cpp \
+    $$PWD/healthbaritem.cpp \
+    $$PWD/healthitem.cpp \
+    $$PWD/hostconfigdialog.cpp \
+    $$PWD/interpolationbuffer.cpp \
+    $$PWD/mainwindow.cpp \
+    $$PWD/mapdata.cpp \
+    $$PWD/mapscene.cpp \
+    $$PWD/mapview.cpp \
+    $$PWD/networkbase.cpp \
+    $$PWD/networkclient.cpp \
+    $$PWD/networkhost.cpp \
+    $$PWD/networkwidget.cpp \
+    $$PWD/playercolor.cpp \
+    $$PWD/playeritem.cpp \
+    $$PWD/projectilesystem.cpp \
+    $$PWD/respawnoverlayitem.cpp \
+    $$PWD/spatialgrid.cpp \
+    $$PWD/texturecache.cpp \
+    $$PWD/timerwheel.cpp \
+    $$PWD/wallfield.cpp \
+    $$PWD/wallitem.cpp \
+    $$PWD/worldsnapshot.cpp
+
+HEADERS += \
+    $$PWD/animationclock.h \
+    $$PWD/assetbundle.h \
+    $$PWD/binarystream.h \
+    $$PWD/bulletitem.h \
+    $$PWD/bulletitempool.h \
+    $$PWD/configdialog.h \
+    $$PWD/crownitem.h \
+    $$PWD/gamestartoverlayitem.h \
+    $$PWD/gameworld.h \
+    $$PWD/geometry.h \
+    $$PWD/healthbaritem.h \
+    $$PWD/healthitem.h \
+    $$PWD/hostconfigdialog.h \
+    $$PWD/interpolationbuffer.h \
+    $$PWD/mainwindow.h \
+    $$PWD/mapdata.h \
+    $$PWD/mapscene.h \
+    $$PWD/mapview.h \
+    $$PWD/networkbase.h \
+    $$PWD/networkclient.h \
+    $$PWD/networkhost.h \
+    $$PWD/networkwidget.h \
+    $$PWD/playercolor.h \
+    $$PWD/playeritem.h \
+    $$PWD/projectilesystem.h \
+    $$PWD/respawnoverlayitem.h \
+    $$PWD/settings.h \
+    $$PWD/spatialgrid.h \
+    $$PWD/texturecache.h \
+    $$PWD/timerwheel.h \
+    $$PWD/wallfield.h \
+    $$PWD/wallitem.h \
+    $$PWD/worldsnapshot.h
+
+FORMS += \
+    $$PWD/configdialog.ui \
+    $$PWD/hostconfigdialog.ui \
+    $$PWD/mainwindow.ui \
+    $$PWD/networkwidget.ui
+
+RESOURCES += \
+    $$PWD/images.qrc \
+    $$PWD/maps.qrc
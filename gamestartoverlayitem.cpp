@@ -1,50 +1,55 @@
 #include "gamestartoverlayitem.h"
+#include "settings.h"
+#include "texturecache.h"
 
-#include <QTimer>
 #include <QDebug>
 
-GameStartOverlayItem::GameStartOverlayItem()
+GameStartOverlayItem::GameStartOverlayItem(AnimationClock* clock) :
+    _clock(clock)
 {
-    x = 0;
-    y = 0;
-    w = 1200;
-    h = 600;
     gameStartIndex = -1;
 
-    //rateTimer->isSingleShot();
-
-    images[0] = QImage(":/images/gameStartOverlay-10.png");
-    images[1] = QImage(":/images/gameStartOverlay-9.png");
-    images[2] = QImage(":/images/gameStartOverlay-8.png");
-    images[3] = QImage(":/images/gameStartOverlay-7.png");
-    images[4] = QImage(":/images/gameStartOverlay-6.png");
-    images[5] = QImage(":/images/gameStartOverlay-5.png");
-    images[6] = QImage(":/images/gameStartOverlay-4.png");
-    images[7] = QImage(":/images/gameStartOverlay-3.png");
-    images[8] = QImage(":/images/gameStartOverlay-2.png");
-    images[9] = QImage(":/images/gameStartOverlay-1.png");
-    images[10] = QImage(":/images/gameStartOverlay-blank.png");
-
-    setRect(x,y,w,h);
-    this->mapToScene(0,0);
-
-    // Set up and configure timer to display images every second
-    rateTimer = new QTimer;
-    connect(rateTimer, SIGNAL(timeout()), this, SLOT(updateImage()));
-    rateTimer->setInterval(1000);
+    // count down from 10
+    TextureCache& textures = TextureCache::instance();
+    for (int i = 0; i < 10; i++)
+    {
+        frames[i] = textures.trimmedPixmap(QString(":/images/gameStart-%1.png").arg(10 - i), offsets[i]);
+    }
+    frames[10] = textures.trimmedPixmap(":/images/gameStart-blank.png", offsets[10]);
+
+    // hit-testing the overlay does not need its alpha mask
+    setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
+
+    // Display a new image every second, for as long as the countdown runs
+    connect(_clock, &AnimationClock::ticked, this, &GameStartOverlayItem::animate);
 }
 
-void GameStartOverlayItem::updateImage()
+void GameStartOverlayItem::start()
 {
-    gameStartIndex = (gameStartIndex + 1) % 11;  // The remainder of index+1 divided by 11 is the index of the image to use
-    imageBrush.setTextureImage(images[gameStartIndex]);
-    this->setPen(Qt::NoPen);
-    this->setBrush(imageBrush);
+    _running = true;
+    _startTime = _clock->time();
+    gameStartIndex = -1;
+}
 
-    //qDebug() << gameStartIndex;
+void GameStartOverlayItem::stop()
+{
+    _running = false;
 }
 
-void GameStartOverlayItem::ResetIndex()
+void GameStartOverlayItem::animate(qint64 time)
 {
-    gameStartIndex = -1;
+    if (!_running)
+    {
+        return;
+    }
+
+    int frame = AnimationClock::frameAt(time - _startTime, OVERLAY_FRAME_INTERVAL, 11);
+    if (frame != gameStartIndex)
+    {
+        gameStartIndex = frame;
+        this->setOffset(offsets[gameStartIndex]);
+        this->setPixmap(frames[gameStartIndex]);
+
+        //qDebug() << gameStartIndex;
+    }
 }
@@ -1,34 +1,42 @@
 #ifndef GAMESTARTOVERLAYITEM_H
 #define GAMESTARTOVERLAYITEM_H
 
-#include <QGraphicsRectItem>
+#include "animationclock.h"
+
+#include <QGraphicsPixmapItem>
 #include <QPainter>
+#include <QPoint>
 #include <QObject>
 
 
-class GameStartOverlayItem: public QObject,public QGraphicsRectItem
+class GameStartOverlayItem: public QObject,public QGraphicsPixmapItem
 {
     Q_OBJECT
 public:
-    GameStartOverlayItem();
-
-    QTimer* rateTimer;
+    explicit GameStartOverlayItem(AnimationClock* clock);
 
     int gameStartIndex;
 
-    void ResetIndex();
+    /*!
+     * \brief Starts counting down from 10, as of the current time of the clock
+     */
+    void start();
+    void stop();
 
 public slots:
-    void updateImage();
+    void animate(qint64 time);
 
 private:
-    QBrush imageBrush;
+    AnimationClock* _clock;
+    bool _running = false;
+    qint64 _startTime = 0;
+
+    QPixmap frames[11];
 
-    QImage images[11];
-    qreal x;
-    qreal y;
-    qreal w;
-    qreal h;
+    /*!
+     * \brief Where each image starts on the map, as only the visible part of each image is kept
+     */
+    QPoint offsets[11];
 };
 
 #endif // GAMESTARTOVERLAYITEM_H
@@ -0,0 +1,569 @@
+#include "gameworld.h"
+#include "geometry.h"
+
+#include <utility>
+
+namespace
+{
+    const qreal PLAYER_RADIUS = PLAYER_SIZE / 2;
+    const qreal BULLET_RADIUS = BULLET_WIDTH / 2;
+    const qreal WALL_MARGIN = WALL_OUTLINE_WIDTH / 2;
+
+    /*!
+     * \brief Where dead players are kept until they respawn, well away from anything they
+     * could collide with.
+     */
+    const QPointF GRAVEYARD(-100, -100);
+
+    QPointF centerOf(QPointF position)
+    {
+        return position + QPointF(PLAYER_RADIUS, PLAYER_RADIUS);
+    }
+
+    QRectF boxOf(QPointF position)
+    {
+        return QRectF(position, QSizeF(PLAYER_SIZE, PLAYER_SIZE));
+    }
+
+    bool circleIntersectsSquare(QPointF center, qreal radius, QPointF topLeft, qreal size)
+    {
+        QPointF closest(qBound(topLeft.x(), center.x(), topLeft.x() + size),
+                        qBound(topLeft.y(), center.y(), topLeft.y() + size));
+
+        return lengthSquared(center - closest) < radius * radius;
+    }
+
+    /*!
+     * \brief Accelerates one axis of a player's velocity towards the held direction, or slows
+     * it down to a stop if neither direction is held.
+     */
+    qreal accelerate(qreal velocity, bool positive, bool negative)
+    {
+        if (positive)
+        {
+            return qMin(velocity + PLAYER_ACCELERATION, PLAYER_MAX_VELOCITY);
+        }
+
+        if (negative)
+        {
+            return qMax(velocity - PLAYER_ACCELERATION, -PLAYER_MAX_VELOCITY);
+        }
+
+        if (velocity < 0.0)
+        {
+            return qMin(velocity + PLAYER_DECELERATION, 0.0);
+        }
+
+        return qMax(velocity - PLAYER_DECELERATION, 0.0);
+    }
+
+    /*!
+     * \brief Resolves a move that ended up somewhere blocked. A diagonal move slides along
+     * whatever blocks it if either axis on its own is free; otherwise the player stays where
+     * it was and bounces back.
+     */
+    template <typename Blocked>
+    QPointF slide(QPointF previous, QPointF& velocity, QPointF position, Blocked blocked)
+    {
+        if (!blocked(position))
+        {
+            return position;
+        }
+
+        if (velocity.x() != 0.0 && velocity.y() != 0.0)
+        {
+            QPointF vertical(previous.x(), previous.y() + velocity.y());
+            if (!blocked(vertical))
+            {
+                return vertical;
+            }
+
+            QPointF horizontal(previous.x() + velocity.x(), previous.y());
+            if (!blocked(horizontal))
+            {
+                return horizontal;
+            }
+        }
+
+        velocity *= -0.75;
+        return previous;
+    }
+}
+
+GameWorld::GameWorld()
+{
+
+}
+
+void GameWorld::loadMap(MapData const& map)
+{
+    _bounds = map.bounds();
+    _grid = SpatialGrid(_bounds);
+    _wallField = WallField(_bounds);
+
+    _walls = map.wallCorners();
+    _wallField.bake(_walls);
+    _wallsChanged = false;
+
+    _healthKits.clear();
+    for (PlayerState& player : _players)
+    {
+        player.spawnPoint = map.spawn(static_cast<int>(player.color));
+        updateGrid(player);
+    }
+}
+
+void GameWorld::addWall(QVector<QPointF> const& polygon)
+{
+    _walls.append(polygon);
+    _wallsChanged = true;
+}
+
+void GameWorld::clearWalls()
+{
+    _walls.clear();
+    _wallsChanged = true;
+}
+
+void GameWorld::addPlayer(PlayerColor color, QPointF spawnPoint)
+{
+    PlayerState* existing = player(color);
+    if (existing == nullptr)
+    {
+        _players.append(PlayerState());
+        existing = &_players.last();
+        existing->color = color;
+    }
+
+    existing->spawnPoint = spawnPoint;
+    existing->position = spawnPoint;
+    existing->previousPosition = spawnPoint;
+}
+
+void GameWorld::removePlayer(PlayerColor color)
+{
+    for (int i = 0; i < _players.size(); i++)
+    {
+        if (_players[i].color == color)
+        {
+            _players.remove(i);
+            _grid.remove(EntityKind::Player, static_cast<quint32>(color));
+            _respawns.cancel(static_cast<quint32>(color));
+            return;
+        }
+    }
+}
+
+PlayerState* GameWorld::player(PlayerColor color)
+{
+    for (PlayerState& player : _players)
+    {
+        if (player.color == color)
+        {
+            return &player;
+        }
+    }
+
+    return nullptr;
+}
+
+PlayerState const* GameWorld::player(PlayerColor color) const
+{
+    for (PlayerState const& player : _players)
+    {
+        if (player.color == color)
+        {
+            return &player;
+        }
+    }
+
+    return nullptr;
+}
+
+void GameWorld::setInput(PlayerColor color, PlayerInput const& input)
+{
+    if (PlayerState* state = player(color))
+    {
+        state->input = input;
+    }
+}
+
+void GameWorld::setPlayerPosition(PlayerColor color, QPointF position)
+{
+    if (PlayerState* state = player(color))
+    {
+        state->simulated = false;
+        state->position = position;
+        state->previousPosition = position;
+    }
+}
+
+bool GameWorld::isPathClear(QPointF from, QPointF to) const
+{
+    auto clear = [this](QPointF a, QPointF b)
+    {
+        return !_wallField.intersectsCapsule(centerOf(a), centerOf(b), PLAYER_RADIUS + WALL_MARGIN);
+    };
+
+    // A player that rounded a corner between two positions went around it, not through it
+    QPointF horizontalFirst(to.x(), from.y());
+    QPointF verticalFirst(from.x(), to.y());
+
+    return clear(from, to)
+           || (clear(from, horizontalFirst) && clear(horizontalFirst, to))
+           || (clear(from, verticalFirst) && clear(verticalFirst, to));
+}
+
+void GameWorld::setPlayerHealth(PlayerColor color, int health, bool hasCrown)
+{
+    PlayerState* state = player(color);
+    if (state == nullptr)
+    {
+        return;
+    }
+
+    if (health <= 0)
+    {
+        if (!state->isDead)
+        {
+            kill(*state);
+        }
+    }
+    else
+    {
+        // A dead player is still in the graveyard, so bring it back the way the timer would
+        if (state->isDead)
+        {
+            _respawns.cancel(static_cast<quint32>(color));
+            respawn(*state);
+        }
+        state->health = qMin(health, PLAYER_MAX_HEALTH);
+    }
+
+    state->hasCrown = hasCrown;
+}
+
+quint32 GameWorld::spawnBullet(PlayerColor shooter, QPointF source, qreal angle)
+{
+    return _bullets.spawn(shooter, source, angle);
+}
+
+quint32 GameWorld::spawnHealthKit(QPointF position)
+{
+    _healthKits.append({ _nextPickupId++, position });
+    _grid.update(EntityKind::Pickup, _healthKits.last().id, boxOf(position));
+    return _healthKits.last().id;
+}
+
+void GameWorld::clearHealthKits()
+{
+    _healthKits.clear();
+    _grid.clear(EntityKind::Pickup);
+}
+
+void GameWorld::placeCrown(QPointF position)
+{
+    _crownPlaced = true;
+    _crownPosition = position;
+}
+
+void GameWorld::reset()
+{
+    for (PlayerState& player : _players)
+    {
+        player.position = player.spawnPoint;
+        player.previousPosition = player.spawnPoint;
+        player.velocity = QPointF();
+        player.input = PlayerInput();
+        player.health = PLAYER_MAX_HEALTH;
+        player.hasCrown = false;
+        player.isDead = false;
+    }
+
+    _respawns.clear();
+    _bullets.clear();
+    clearHealthKits();
+    _crownPlaced = false;
+}
+
+void GameWorld::step()
+{
+    // Walls only change between games, so the wall field is rebuilt at most once per map
+    if (_wallsChanged)
+    {
+        _wallField.bake(_walls);
+        _wallsChanged = false;
+    }
+
+    _time += SIMULATION_STEP;
+
+    // Players may have been positioned from outside since the last step
+    for (PlayerState& player : _players)
+    {
+        player.previousPosition = player.position;
+        updateGrid(player);
+    }
+
+    respawnPlayers();
+
+    for (PlayerState& player : _players)
+    {
+        movePlayer(player);
+    }
+
+    moveBullets();
+
+    // Pick up whatever players are touching, including players the world does not move
+    for (PlayerState& player : _players)
+    {
+        if (player.isDead)
+        {
+            continue;
+        }
+
+        QPointF center = centerOf(player.position);
+
+        if (_crownPlaced && circleIntersectsSquare(center, PLAYER_RADIUS, _crownPosition, PLAYER_SIZE))
+        {
+            _crownPlaced = false;
+            player.hasCrown = true;
+        }
+
+        _grid.query(EntityKind::Pickup, boxOf(player.position), _candidates);
+        for (quint32 id : qAsConst(_candidates))
+        {
+            int i = healthKitIndex(id);
+            if (i >= 0 && circleIntersectsSquare(center, PLAYER_RADIUS, _healthKits[i].position, PLAYER_SIZE))
+            {
+                // Picking up a health kit restores all health
+                _healthKits.remove(i);
+                _grid.remove(EntityKind::Pickup, id);
+                player.health = PLAYER_MAX_HEALTH;
+                break;
+            }
+        }
+    }
+}
+
+void GameWorld::movePlayer(PlayerState& player)
+{
+    if (!player.simulated || player.isDead)
+    {
+        return;
+    }
+
+    player.velocity.setX(accelerate(player.velocity.x(), player.input.right, player.input.left));
+    player.velocity.setY(accelerate(player.velocity.y(), player.input.down, player.input.up));
+
+    QPointF previous = player.position;
+    QPointF position = slide(previous, player.velocity, previous + player.velocity,
+                             [this](QPointF p) { return collidesWithWall(p); });
+
+    if (PlayerState* other = collidingPlayer(player, position))
+    {
+        // Bumping into the crown holder takes the crown, and bumping into anyone
+        //  while holding it gives it away
+        if (player.hasCrown != other->hasCrown)
+        {
+            std::swap(player.hasCrown, other->hasCrown);
+        }
+
+        position = slide(previous, player.velocity, position,
+                         [this, &player](QPointF p) { return collidesWithWall(p) || collidingPlayer(player, p) != nullptr; });
+    }
+
+    player.position = position;
+    updateGrid(player);
+}
+
+void GameWorld::moveBullets()
+{
+    qreal travel = BULLET_SPEED * SIMULATION_STEP;
+    qreal hitDistance = PLAYER_RADIUS + BULLET_RADIUS;
+
+    // Look for hits first, then move every bullet that survived in one pass
+    for (int slot = 0; slot < _bullets.capacity(); slot++)
+    {
+        if (!_bullets.isAlive(slot))
+        {
+            continue;
+        }
+
+        QPointF direction = _bullets.direction(slot);
+        PlayerColor shooter = _bullets.shooter(slot);
+        QPointF rear = _bullets.position(slot);
+        QPointF tip = rear + direction * BULLET_LENGTH;
+
+        // Bullets only move along themselves, so everything a bullet runs into this step lies on
+        //  the line its tip sweeps. Find the first wall and the first player in the way.
+        qreal wallDistance = 0.0;
+        bool hitsWall = _wallField.sweepCircle(tip, direction, travel, BULLET_RADIUS + WALL_MARGIN, wallDistance);
+
+        PlayerState* target = nullptr;
+        qreal targetTime = hitsWall ? wallDistance / travel : 1.0;
+
+        // Players moved earlier this step, by at most their maximum velocity
+        qreal reach = BULLET_RADIUS + PLAYER_MAX_VELOCITY;
+        QRectF box = QRectF(rear, tip + direction * travel).normalized().adjusted(-reach, -reach, reach, reach);
+        _grid.query(EntityKind::Player, box, _candidates);
+
+        for (quint32 id : qAsConst(_candidates))
+        {
+            PlayerState* candidate = player(static_cast<PlayerColor>(id));
+            if (candidate == nullptr || candidate->isDead || candidate->color == shooter)
+            {
+                continue;
+            }
+
+            // Sweep the tip against the player's own movement during the step
+            QPointF start = centerOf(candidate->previousPosition);
+            QPointF end = centerOf(candidate->position);
+            qreal time = 0.0;
+
+            bool touching = distanceSquaredToSegment(start, rear, tip) < hitDistance * hitDistance;
+            if (!touching && !firstContactTime(tip - start, direction * travel - (end - start), hitDistance, time))
+            {
+                continue;
+            }
+
+            if (time <= targetTime)
+            {
+                target = candidate;
+                targetTime = time;
+            }
+        }
+
+        if (target != nullptr)
+        {
+            damage(*target, shooter);
+        }
+
+        QPointF next = rear + direction * travel;
+        bool leavesMap = !_bounds.contains(next);
+
+        if (target != nullptr || hitsWall || leavesMap)
+        {
+            _bullets.remove(slot);
+        }
+    }
+
+    _bullets.advance(travel, SIMULATION_STEP);
+}
+
+void GameWorld::respawnPlayers()
+{
+    // Only the players whose respawn time has come are looked at
+    _respawns.advance(_time, _respawning);
+    for (quint32 color : qAsConst(_respawning))
+    {
+        PlayerState* respawned = player(static_cast<PlayerColor>(color));
+        if (respawned != nullptr && respawned->isDead)
+        {
+            respawn(*respawned);
+        }
+    }
+}
+
+void GameWorld::respawn(PlayerState& player)
+{
+    player.isDead = false;
+    player.health = PLAYER_MAX_HEALTH;
+    player.velocity = QPointF();
+    player.position = player.spawnPoint;
+
+    // Do not respawn on top of another player
+    if (collidingPlayer(player, player.position))
+    {
+        player.position.ry() -= PLAYER_SIZE * 2;
+    }
+
+    player.previousPosition = player.position;
+    updateGrid(player);
+}
+
+void GameWorld::damage(PlayerState& target, PlayerColor shooter)
+{
+    target.health -= BULLET_DAMAGE;
+    if (target.health > 0)
+    {
+        return;
+    }
+
+    kill(target);
+
+    if (target.hasCrown)
+    {
+        target.hasCrown = false;
+
+        if (PlayerState* killer = player(shooter))
+        {
+            killer->hasCrown = true;
+        }
+    }
+}
+
+void GameWorld::kill(PlayerState& player)
+{
+    player.isDead = true;
+    player.health = 0;
+    player.velocity = QPointF();
+    player.position = GRAVEYARD;
+    player.previousPosition = GRAVEYARD;
+    player.respawnAt = _time + PLAYER_RESPAWN_TIME;
+    _respawns.schedule(static_cast<quint32>(player.color), player.respawnAt);
+    updateGrid(player);
+}
+
+bool GameWorld::collidesWithWall(QPointF position) const
+{
+    return _wallField.intersectsCircle(centerOf(position), PLAYER_RADIUS + WALL_MARGIN);
+}
+
+PlayerState* GameWorld::collidingPlayer(PlayerState const& player, QPointF position)
+{
+    QPointF center = centerOf(position);
+
+    // Overlapping players always have overlapping boxes
+    _grid.query(EntityKind::Player, boxOf(position), _candidates);
+    for (quint32 id : qAsConst(_candidates))
+    {
+        PlayerState* other = this->player(static_cast<PlayerColor>(id));
+        if (other == nullptr || other->color == player.color || other->isDead)
+        {
+            continue;
+        }
+
+        if (lengthSquared(centerOf(other->position) - center) < PLAYER_SIZE * PLAYER_SIZE)
+        {
+            return other;
+        }
+    }
+
+    return nullptr;
+}
+
+void GameWorld::updateGrid(PlayerState const& player)
+{
+    // Dead players cannot be collided with
+    if (player.isDead)
+    {
+        _grid.remove(EntityKind::Player, static_cast<quint32>(player.color));
+    }
+    else
+    {
+        _grid.update(EntityKind::Player, static_cast<quint32>(player.color), boxOf(player.position));
+    }
+}
+
+int GameWorld::healthKitIndex(quint32 id) const
+{
+    for (int i = 0; i < _healthKits.size(); i++)
+    {
+        if (_healthKits[i].id == id)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
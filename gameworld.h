@@ -0,0 +1,304 @@
+#ifndef GAMEWORLD_H
+#define GAMEWORLD_H
+
+#include "mapdata.h"
+#include "playercolor.h"
+#include "projectilesystem.h"
+#include "settings.h"
+#include "spatialgrid.h"
+#include "timerwheel.h"
+#include "wallfield.h"
+
+#include <QPointF>
+#include <QVector>
+
+/*!
+ * \brief The PlayerInput struct holds which movement keys a player is holding down.
+ */
+struct PlayerInput
+{
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+};
+
+/*!
+ * \brief The PlayerState struct holds the simulated state of a single player.
+ */
+struct PlayerState
+{
+    PlayerColor color = PlayerColor::Red;
+
+    /*!
+     * \brief The position of the top left corner of the player, in scene coordinates.
+     */
+    QPointF position;
+
+    /*!
+     * \brief The position of the player before the last step, so that rendering can
+     * interpolate between steps.
+     */
+    QPointF previousPosition;
+
+    /*!
+     * \brief The velocity of the player, in pixels per step.
+     */
+    QPointF velocity;
+
+    PlayerInput input;
+    QPointF spawnPoint;
+
+    int health = PLAYER_MAX_HEALTH;
+    bool hasCrown = false;
+    bool isDead = false;
+
+    /*!
+     * \brief The world time (in milliseconds) at which a dead player respawns.
+     */
+    qint64 respawnAt = 0;
+
+    /*!
+     * \brief Whether the world moves the player according to its input. Players whose
+     * position is decided elsewhere, such as remote players, are only positioned.
+     */
+    bool simulated = true;
+};
+
+/*!
+ * \brief The PickupState struct holds a health kit that is waiting to be picked up.
+ */
+struct PickupState
+{
+    quint32 id = 0;
+
+    /*!
+     * \brief The position of the top left corner of the health kit.
+     */
+    QPointF position;
+};
+
+/*!
+ * \brief The GameWorld class simulates the game: player movement, collisions with walls and other
+ * players, bullets, damage, death and respawn, the crown and health kits. It only depends on plain
+ * data, so it can run without a scene, and it always advances in steps of SIMULATION_STEP.
+ */
+class GameWorld
+{
+public:
+    GameWorld();
+
+    /*!
+     * \brief Replaces the walls and bounds of the world with those of a map, and moves every
+     * player's spawn point to the map's. Wall collisions are baked right away instead of on
+     * the next step, and every health kit is removed.
+     * \param map the map
+     */
+    void loadMap(MapData const& map);
+
+    inline QRectF const& bounds() const
+    {
+        return _bounds;
+    }
+
+    /*!
+     * \brief Adds a static wall to the world.
+     * \param polygon the corners of the wall, in scene coordinates
+     */
+    void addWall(QVector<QPointF> const& polygon);
+
+    /*!
+     * \brief Removes every wall from the world.
+     */
+    void clearWalls();
+
+    inline QVector<QVector<QPointF>> const& walls() const
+    {
+        return _walls;
+    }
+
+    /*!
+     * \brief Adds a player to the world at its spawn point.
+     * \param color the color of the player
+     * \param spawnPoint the position the player starts and respawns at
+     */
+    void addPlayer(PlayerColor color, QPointF spawnPoint);
+
+    void removePlayer(PlayerColor color);
+
+    PlayerState* player(PlayerColor color);
+    PlayerState const* player(PlayerColor color) const;
+
+    inline QVector<PlayerState> const& players() const
+    {
+        return _players;
+    }
+
+    /*!
+     * \brief Sets which movement keys a simulated player is holding down.
+     * \param color the color of the player
+     * \param input the keys being held down
+     */
+    void setInput(PlayerColor color, PlayerInput const& input);
+
+    /*!
+     * \brief Moves a player to a position decided outside the world. From then on, the world
+     * no longer moves the player by itself.
+     * \param color the color of the player
+     * \param position the new position of the player
+     */
+    void setPlayerPosition(PlayerColor color, QPointF position);
+
+    /*!
+     * \brief Returns whether a player can get from one position to another without passing
+     * through a wall, either in a straight line or one axis at a time, the way players slide
+     * along walls. Walls added since the last step are not taken into account.
+     * \param from the position the player moves from
+     * \param to the position the player moves to
+     * \return true or false
+     */
+    bool isPathClear(QPointF from, QPointF to) const;
+
+    /*!
+     * \brief Sets a player's health and crown as decided outside the world, killing the player
+     * if its health has run out. A dead player given health respawns right away.
+     * \param color the color of the player
+     * \param health the new health of the player
+     * \param hasCrown whether or not the player has the crown
+     */
+    void setPlayerHealth(PlayerColor color, int health, bool hasCrown);
+
+    /*!
+     * \brief Fires a bullet.
+     * \param shooter the color of the player who fired the bullet
+     * \param source the position the bullet was fired from
+     * \param angle the angle at which the bullet travels
+     * \return the id of the new bullet
+     */
+    quint32 spawnBullet(PlayerColor shooter, QPointF source, qreal angle);
+
+    inline ProjectileSystem const& bullets() const
+    {
+        return _bullets;
+    }
+
+    /*!
+     * \brief Places a health kit in the world.
+     * \param position the position of the top left corner of the health kit
+     * \return the id of the new health kit
+     */
+    quint32 spawnHealthKit(QPointF position);
+
+    void clearHealthKits();
+
+    inline QVector<PickupState> const& healthKits() const
+    {
+        return _healthKits;
+    }
+
+    /*!
+     * \brief Places the crown in the world, for the first player to touch it to pick up.
+     * \param position the position of the top left corner of the crown
+     */
+    void placeCrown(QPointF position);
+
+    inline bool isCrownPlaced() const
+    {
+        return _crownPlaced;
+    }
+
+    inline QPointF crownPosition() const
+    {
+        return _crownPosition;
+    }
+
+    /*!
+     * \brief Starts a new game: every player returns to its spawn point with full health
+     * and no crown, and every bullet and health kit is removed.
+     */
+    void reset();
+
+    /*!
+     * \brief Advances the world by SIMULATION_STEP milliseconds.
+     */
+    void step();
+
+    /*!
+     * \brief Returns the world time, which starts at 0 and advances by SIMULATION_STEP
+     * milliseconds per step.
+     * \return the world time, in milliseconds
+     */
+    inline qint64 time() const
+    {
+        return _time;
+    }
+
+private:
+    void movePlayer(PlayerState& player);
+    void moveBullets();
+    void respawnPlayers();
+
+    /*!
+     * \brief Brings a dead player back to life at its spawn point with full health.
+     */
+    void respawn(PlayerState& player);
+
+    /*!
+     * \brief Applies a bullet hit to a player, killing the player if its health runs out.
+     * A player killed while holding the crown loses it to the shooter.
+     */
+    void damage(PlayerState& target, PlayerColor shooter);
+
+    void kill(PlayerState& player);
+
+    bool collidesWithWall(QPointF position) const;
+    PlayerState* collidingPlayer(PlayerState const& player, QPointF position);
+
+    /*!
+     * \brief Moves a player's entry in the grid to where the player is now
+     */
+    void updateGrid(PlayerState const& player);
+
+    int healthKitIndex(quint32 id) const;
+
+    QVector<QVector<QPointF>> _walls;
+
+    /*!
+     * \brief The area players and bullets stay within
+     */
+    QRectF _bounds = QRectF(0, 0, MAP_WIDTH, MAP_HEIGHT);
+
+    /*!
+     * \brief Answers every wall collision query, rebuilt on the next step whenever the walls change
+     */
+    WallField _wallField;
+    bool _wallsChanged = false;
+    QVector<PlayerState> _players;
+    ProjectileSystem _bullets;
+    QVector<PickupState> _healthKits;
+
+    /*!
+     * \brief Every living player and health kit, for finding what is near what. Players are
+     * stored by color and health kits by id.
+     */
+    SpatialGrid _grid;
+
+    /*!
+     * \brief Reused for the results of grid queries, to save allocating every query
+     */
+    mutable QVector<quint32> _candidates;
+
+    /*!
+     * \brief When each dead player respawns, by color
+     */
+    TimerWheel _respawns;
+    QVector<quint32> _respawning;
+
+    bool _crownPlaced = false;
+    QPointF _crownPosition;
+
+    qint64 _time = 0;
+    quint32 _nextPickupId = 1;
+};
+
+#endif // GAMEWORLD_H
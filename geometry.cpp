@@ -0,0 +1,99 @@
+#include "geometry.h"
+
+#include <QtMath>
+
+namespace
+{
+    qreal cross(QPointF a, QPointF b)
+    {
+        return a.x() * b.y() - a.y() * b.x();
+    }
+}
+
+qreal lengthSquared(QPointF vector)
+{
+    return QPointF::dotProduct(vector, vector);
+}
+
+qreal distanceSquaredToSegment(QPointF point, QPointF a, QPointF b)
+{
+    QPointF ab = b - a;
+    qreal length = lengthSquared(ab);
+    qreal t = length > 0.0 ? qBound(0.0, QPointF::dotProduct(point - a, ab) / length, 1.0) : 0.0;
+
+    return lengthSquared(point - (a + ab * t));
+}
+
+bool segmentsIntersect(QPointF p1, QPointF p2, QPointF q1, QPointF q2)
+{
+    QPointF r = p2 - p1;
+    QPointF s = q2 - q1;
+    qreal denominator = cross(r, s);
+
+    if (qFuzzyIsNull(denominator))
+    {
+        return false;
+    }
+
+    qreal t = cross(q1 - p1, s) / denominator;
+    qreal u = cross(q1 - p1, r) / denominator;
+    return t >= 0.0 && t <= 1.0 && u >= 0.0 && u <= 1.0;
+}
+
+qreal distanceSquaredBetweenSegments(QPointF p1, QPointF p2, QPointF q1, QPointF q2)
+{
+    if (segmentsIntersect(p1, p2, q1, q2))
+    {
+        return 0.0;
+    }
+
+    return qMin(qMin(distanceSquaredToSegment(p1, q1, q2), distanceSquaredToSegment(p2, q1, q2)),
+                qMin(distanceSquaredToSegment(q1, p1, p2), distanceSquaredToSegment(q2, p1, p2)));
+}
+
+bool firstContactTime(QPointF offset, QPointF velocity, qreal radius, qreal& time)
+{
+    // Solve |offset + velocity * t| = radius for the earliest t
+    qreal c = lengthSquared(offset) - radius * radius;
+    if (c <= 0.0)
+    {
+        time = 0.0;
+        return true;
+    }
+
+    qreal a = lengthSquared(velocity);
+    qreal b = 2.0 * QPointF::dotProduct(offset, velocity);
+    qreal discriminant = b * b - 4.0 * a * c;
+    if (qFuzzyIsNull(a) || discriminant < 0.0)
+    {
+        return false;
+    }
+
+    qreal t = (-b - qSqrt(discriminant)) / (2.0 * a);
+    if (t < 0.0 || t > 1.0)
+    {
+        return false;
+    }
+
+    time = t;
+    return true;
+}
+
+bool polygonContainsPoint(QVector<QPointF> const& polygon, QPointF point)
+{
+    bool inside = false;
+
+    for (int i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+    {
+        QPointF const& a = polygon[i];
+        QPointF const& b = polygon[j];
+
+        if ((a.y() > point.y()) != (b.y() > point.y())
+            && point.x() < (b.x() - a.x()) * (point.y() - a.y()) / (b.y() - a.y()) + a.x())
+        {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
@@ -0,0 +1,43 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <QPointF>
+#include <QVector>
+
+/*!
+ * \brief Returns the squared length of a vector.
+ */
+qreal lengthSquared(QPointF vector);
+
+/*!
+ * \brief Returns the squared distance from a point to the closest point of a line segment.
+ */
+qreal distanceSquaredToSegment(QPointF point, QPointF a, QPointF b);
+
+/*!
+ * \brief Returns whether two line segments cross or touch.
+ */
+bool segmentsIntersect(QPointF p1, QPointF p2, QPointF q1, QPointF q2);
+
+/*!
+ * \brief Returns the squared distance between the closest points of two line segments.
+ */
+qreal distanceSquaredBetweenSegments(QPointF p1, QPointF p2, QPointF q1, QPointF q2);
+
+/*!
+ * \brief Finds when a point moving in a straight line first comes within a distance of the origin.
+ * \param offset where the point starts, relative to the origin
+ * \param velocity how far the point moves over the whole time span
+ * \param radius the distance at which the point touches the origin
+ * \param time set to when the point first touches, from 0 (at the start) to 1 (at the end)
+ * \return whether the point touches the origin within the time span
+ */
+bool firstContactTime(QPointF offset, QPointF velocity, qreal radius, qreal& time);
+
+/*!
+ * \brief Returns whether a point lies inside a polygon, using the same odd-even rule
+ * that walls are filled with.
+ */
+bool polygonContainsPoint(QVector<QPointF> const& polygon, QPointF point);
+
+#endif // GEOMETRY_H
@@ -1,8 +1,8 @@
 #include "healthitem.h"
+#include "settings.h"
+#include "texturecache.h"
 
-#include <QTimer>
-
-HealthItem::HealthItem(qreal xPos, qreal yPos)
+HealthItem::HealthItem(qreal xPos, qreal yPos, AnimationClock* clock)
 {
     x = xPos;  // passed x position set
     y = yPos;  // passed y position set
@@ -10,38 +10,35 @@ HealthItem::HealthItem(qreal xPos, qreal yPos)
     h = 25;  // height of item
     index = 0;  // index for the animation images
 
-    images[0] = QImage(":/images/health-1.png");
-    images[1] = QImage(":/images/health-1.png");
-    images[2] = QImage(":/images/health-1.png");
-    images[3] = QImage(":/images/health-1.png");
-    images[4] = QImage(":/images/health-1.png");
-    images[5] = QImage(":/images/health-1.png");
-    images[6] = QImage(":/images/health-1.png");
-    images[7] = QImage(":/images/health-1.png");
-    images[8] = QImage(":/images/health-1.png");
-    images[9] = QImage(":/images/health-1.png");
-    images[10] = QImage(":/images/health-2.png");
-    images[11] = QImage(":/images/health-3.png");
-    images[12] = QImage(":/images/health-4.png");
-    images[13] = QImage(":/images/health-5.png");
-    images[14] = QImage(":/images/health-6.png");
+    // the first image is held for 10 frames before the rest of the animation plays
+    TextureCache& textures = TextureCache::instance();
+    for (int i = 0; i < 10; i++)
+    {
+        frames[i] = textures.pixmap(":/images/health-1.png");
+    }
+    for (int i = 10; i < 15; i++)
+    {
+        frames[i] = textures.pixmap(QString(":/images/health-%1.png").arg(i - 8));
+    }
 
     // set position relative to scene
-    setRect(x,y,w,h);
-    this->mapToScene(0,0);
+    setPos(x,y);
+    setPixmap(frames[index]);
 
-    // create a timer for redrawing the animation images
-    QTimer* rateTimer = new QTimer;
-    connect(rateTimer, SIGNAL(timeout()), this, SLOT(updateImage()));
-    rateTimer->setInterval(80);
-    rateTimer->start();
+    // the animation moves on with the clock, and stops with the item
+    startTime = clock->time();
+    connect(clock, &AnimationClock::ticked, this, &HealthItem::animate);
 }
 
 
-void HealthItem::updateImage()
+void HealthItem::animate(qint64 time)
 {
-    index = (index + 1) % 15;
-    healthBrush.setTextureImage(images[index]);
-    this->setPen(Qt::NoPen);
-    this->setBrush(healthBrush);
+    int frame = AnimationClock::frameAt(time - startTime, HEALTH_KIT_FRAME_INTERVAL, 15);
+
+    // only changing images needs a repaint
+    if (frame != index)
+    {
+        index = frame;
+        this->setPixmap(frames[index]);
+    }
 }
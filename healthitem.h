@@ -1,7 +1,9 @@
 #ifndef HEALTHITEM_H
 #define HEALTHITEM_H
 
-#include <QGraphicsRectItem>
+#include "animationclock.h"
+
+#include <QGraphicsPixmapItem>
 #include <QPainter>
 #include <QObject>
 
@@ -9,32 +11,28 @@
 /*!
  * \brief HealthItem class is a collectable item that regains player health.
  */
-class HealthItem : public QObject, public QGraphicsRectItem
+class HealthItem : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
 public:
     /*!
-     * \brief Constructs a health item.
+     * \brief Constructs a health item, animated from the moment it is created.
+     * \param clock the clock that animates the item
      */
-    explicit HealthItem(qreal xPos, qreal yPos);
+    explicit HealthItem(qreal xPos, qreal yPos, AnimationClock* clock);
 
 public slots:
     /*!
-     * \brief Slot that updates on a timer to update the image and
-     * animate the health item.
+     * \brief Shows the image of the animation for the current time.
+     * \param time the time of the animation clock
      */
-    void updateImage();
+    void animate(qint64 time);
 
 private:
-    /*!
-     * \brief The brush used to draw the health item.
-     */
-    QBrush healthBrush;
-
     /*!
      * \brief An array of images used to animate the health item.
      */
-    QImage images[15];
+    QPixmap frames[15];
 
     /*!
      * \brief Starting x position to map to scene.
@@ -57,9 +55,14 @@ private:
     qreal h;
 
     /*!
-     * \brief Index used to swap images.
+     * \brief Index of the image shown.
      */
     int index;
+
+    /*!
+     * \brief The time of the animation clock when the item was created
+     */
+    qint64 startTime;
 };
 
 #endif // HEALTHITEM_H
@@ -0,0 +1,69 @@
+#include "interpolationbuffer.h"
+
+InterpolationBuffer::InterpolationBuffer(int capacity)
+    : _capacity(qMax(2, capacity))
+{
+    _samples.reserve(_capacity);
+}
+
+void InterpolationBuffer::addSample(qint64 time, QPointF position)
+{
+    if (!_samples.isEmpty() && time <= _samples.last().time)
+    {
+        return;
+    }
+
+    if (_samples.size() >= _capacity)
+    {
+        _samples.removeFirst();
+    }
+
+    _samples.append({ time, position });
+}
+
+void InterpolationBuffer::clear()
+{
+    _samples.clear();
+}
+
+QPointF InterpolationBuffer::position(qint64 time) const
+{
+    if (_samples.isEmpty())
+    {
+        return QPointF();
+    }
+
+    if (time <= _samples.first().time)
+    {
+        return _samples.first().position;
+    }
+
+    // Find the pair of samples that brackets the time, searching from the newest since
+    //  the render time trails the newest sample by only a few samples
+    for (int i = _samples.size() - 1; i > 0; i--)
+    {
+        Sample const& before = _samples[i - 1];
+        Sample const& after = _samples[i];
+
+        if (time >= before.time && time <= after.time)
+        {
+            qreal t = static_cast<qreal>(time - before.time) / (after.time - before.time);
+            return before.position + (after.position - before.position) * t;
+        }
+    }
+
+    // The next sample is late, so keep moving the way the player was last moving,
+    //  but not for so long that the guess strays far from the truth
+    Sample const& last = _samples.last();
+    if (_samples.size() < 2)
+    {
+        return last.position;
+    }
+
+    Sample const& previous = _samples[_samples.size() - 2];
+    qint64 ahead = qMin(time - last.time, static_cast<qint64>(INTERPOLATION_MAX_EXTRAPOLATION));
+    qreal t = static_cast<qreal>(ahead) / (last.time - previous.time);
+
+    _extrapolations++;
+    return last.position + (last.position - previous.position) * t;
+}
@@ -0,0 +1,73 @@
+#ifndef INTERPOLATIONBUFFER_H
+#define INTERPOLATIONBUFFER_H
+
+#include "settings.h"
+
+#include <QPointF>
+#include <QVector>
+
+/*!
+ * \brief The InterpolationBuffer class holds the most recent positions received for a remote
+ * player. Remote players are drawn a short delay behind the newest position, so that there is
+ * nearly always a pair of positions to interpolate between and network jitter does not show.
+ */
+class InterpolationBuffer
+{
+public:
+    /*!
+     * \brief Creates an empty buffer.
+     * \param capacity the number of positions to keep
+     */
+    explicit InterpolationBuffer(int capacity = INTERPOLATION_BUFFER_SIZE);
+
+    /*!
+     * \brief Adds a position to the buffer. Positions older than the newest one in the
+     * buffer arrived out of order and are ignored.
+     * \param time the time (in milliseconds) at which the player was at the position
+     * \param position the position of the player
+     */
+    void addSample(qint64 time, QPointF position);
+
+    /*!
+     * \brief Removes every position from the buffer.
+     */
+    void clear();
+
+    inline bool isEmpty() const
+    {
+        return _samples.isEmpty();
+    }
+
+    /*!
+     * \brief Returns the position of the player at the specified time, interpolated between
+     * the positions received just before and just after it. If no position after it has been
+     * received yet, the player's last known movement is continued for at most
+     * INTERPOLATION_MAX_EXTRAPOLATION milliseconds.
+     * \param time the time (in milliseconds) to return the position for
+     * \return the position of the player
+     */
+    QPointF position(qint64 time) const;
+
+    /*!
+     * \brief Returns the number of times position() had to extrapolate because the next
+     * position had not arrived yet.
+     * \return the number of extrapolations
+     */
+    inline int extrapolations() const
+    {
+        return _extrapolations;
+    }
+
+private:
+    struct Sample
+    {
+        qint64 time;
+        QPointF position;
+    };
+
+    QVector<Sample> _samples;
+    int _capacity;
+    mutable int _extrapolations = 0;
+};
+
+#endif // INTERPOLATIONBUFFER_H
@@ -1,11 +1,22 @@
+#include "assetbundle.h"
 #include "mainwindow.h"
+#include "texturecache.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
 #include <QLocale>
+#include <QSplashScreen>
+#include <QTimer>
 #include <QTranslator>
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     QApplication a(argc, argv);
 
     QTranslator translator;
@@ -17,7 +28,70 @@ int main(int argc, char *argv[])
             break;
         }
     }
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption assetsOption("assets", QObject::tr("Load textures and maps from the asset bundle <file>."),
+                                    QObject::tr("file"), a.applicationDirPath() + "/crownhunters.assets");
+    QCommandLineOption packOption("pack-assets", QObject::tr("Decode every texture and map into the asset bundle <file>, then quit."),
+                                  QObject::tr("file"));
+    parser.addOption(assetsOption);
+    parser.addOption(packOption);
+    parser.process(a);
+
+    if (parser.isSet(packOption))
+    {
+        QHash<QString, QImage> images;
+        QDirIterator imageIt(":/images", { "*.png" }, QDir::Files);
+        while (imageIt.hasNext())
+        {
+            QString path = imageIt.next();
+            images.insert(path, TextureCache::instance().image(path));
+        }
+
+        QHash<QString, MapData> maps;
+        QDirIterator mapIt(":/maps", { "*.map" }, QDir::Files);
+        while (mapIt.hasNext())
+        {
+            QString path = mapIt.next();
+            MapData map;
+            if (MapData::load(path, map))
+            {
+                maps.insert(path, map);
+            }
+        }
+
+        return AssetBundle::pack(parser.value(packOption), images, maps) ? 0 : 1;
+    }
+
+    // A packed bundle is optional, anything it does not hold is decoded from the resources
+    if (QFile::exists(parser.value(assetsOption)))
+    {
+        AssetBundle::instance().open(parser.value(assetsOption));
+    }
+
+    // Decode every image up front, so that nothing decodes mid-game
+    QPixmap splashImage(400, 100);
+    splashImage.fill(Qt::black);
+    QSplashScreen splash(splashImage);
+    splash.show();
+
+    // The cache outlives the application object, but the pixmaps in it may not
+    QObject::connect(&a, &QApplication::aboutToQuit, [] { TextureCache::instance().clear(); });
+
+    TextureCache::instance().preload([&splash](int done, int total)
+    {
+        splash.showMessage(QObject::tr("Loading textures %1/%2").arg(done).arg(total), Qt::AlignCenter, Qt::white);
+    });
+
     MainWindow w;
     w.show();
+    splash.finish(&w);
+
+    // The first event processed after showing the window is the first frame the user can interact with
+    QTimer::singleShot(0, [&startup]
+    {
+        qDebug() << "First interactive frame after" << startup.elapsed() << "ms";
+    });
     return a.exec();
 }
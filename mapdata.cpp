@@ -0,0 +1,374 @@
+#include "mapdata.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace
+{
+    /*!
+     * \brief The first four bytes of a binary map file, "CHMP" in little-endian order
+     */
+    const quint32 MAP_FILE_MAGIC = 0x504d4843;
+    const quint8 MAP_FILE_VERSION = 1;
+
+    /*!
+     * \brief The fewest corners a wall can have and still enclose an area
+     */
+    const int MIN_WALL_CORNERS = 3;
+
+    void writePoints(BinaryWriter& writer, QVector<QPointF> const& points)
+    {
+        writer.writeUInt16(static_cast<quint16>(qMin(points.size(), 0xffff)));
+        for (int i = 0; i < points.size() && i < 0xffff; i++)
+        {
+            writer.writeFloat(points[i].x());
+            writer.writeFloat(points[i].y());
+        }
+    }
+
+    QVector<QPointF> readPoints(BinaryReader& reader)
+    {
+        int count = reader.readUInt16();
+
+        QVector<QPointF> points;
+        points.reserve(count);
+        for (int i = 0; i < count && reader.ok(); i++)
+        {
+            qreal x = reader.readFloat();
+            qreal y = reader.readFloat();
+            points.append(QPointF(x, y));
+        }
+
+        return points;
+    }
+
+    QString pointsToText(QVector<QPointF> const& points)
+    {
+        QStringList numbers;
+        for (QPointF const& point : points)
+        {
+            numbers << QString::number(point.x()) << QString::number(point.y());
+        }
+
+        return numbers.join(QLatin1Char(' '));
+    }
+
+    /*!
+     * \brief Parses pairs of numbers into points.
+     * \return whether there was an even, non-zero number of valid numbers
+     */
+    bool parsePoints(QStringList const& tokens, int first, QVector<QPointF>& points)
+    {
+        if (tokens.size() <= first || (tokens.size() - first) % 2 != 0)
+        {
+            return false;
+        }
+
+        for (int i = first; i < tokens.size(); i += 2)
+        {
+            bool xOk = false;
+            bool yOk = false;
+            qreal x = tokens[i].toDouble(&xOk);
+            qreal y = tokens[i + 1].toDouble(&yOk);
+            if (!xOk || !yOk)
+            {
+                return false;
+            }
+
+            points.append(QPointF(x, y));
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Parses a color written as #rrggbb or #aarrggbb.
+     */
+    bool parseColor(QString const& token, quint32& color)
+    {
+        if (!token.startsWith(QLatin1Char('#')) || (token.size() != 7 && token.size() != 9))
+        {
+            return false;
+        }
+
+        bool ok = false;
+        color = token.mid(1).toUInt(&ok, 16);
+        if (token.size() == 7)
+        {
+            color |= 0xff000000;
+        }
+
+        return ok;
+    }
+
+    QString colorToText(quint32 color)
+    {
+        if ((color >> 24) == 0xff)
+        {
+            return QStringLiteral("#%1").arg(color & 0xffffff, 6, 16, QLatin1Char('0'));
+        }
+
+        return QStringLiteral("#%1").arg(color, 8, 16, QLatin1Char('0'));
+    }
+}
+
+QPointF MapData::spawn(int index) const
+{
+    if (spawns.isEmpty())
+    {
+        return bounds().center();
+    }
+
+    return spawns[qAbs(index) % spawns.size()];
+}
+
+QVector<QVector<QPointF>> MapData::wallCorners() const
+{
+    QVector<QVector<QPointF>> corners;
+    corners.reserve(walls.size());
+
+    for (MapWall const& wall : walls)
+    {
+        corners.append(wall.corners);
+    }
+
+    return corners;
+}
+
+void MapData::write(BinaryWriter& writer) const
+{
+    writer.writeString(name);
+    writer.writeFloat(width);
+    writer.writeFloat(height);
+    writer.writeFloat(crownStart.x());
+    writer.writeFloat(crownStart.y());
+
+    writer.writeUInt16(static_cast<quint16>(walls.size()));
+    for (MapWall const& wall : walls)
+    {
+        writer.writeUInt32(wall.outline);
+        writePoints(writer, wall.corners);
+    }
+
+    writePoints(writer, spawns);
+
+    writer.writeUInt16(static_cast<quint16>(healthKitWaves.size()));
+    for (QVector<QPointF> const& wave : healthKitWaves)
+    {
+        writePoints(writer, wave);
+    }
+}
+
+bool MapData::read(BinaryReader& reader)
+{
+    *this = MapData();
+
+    name = reader.readString();
+    width = reader.readFloat();
+    height = reader.readFloat();
+    crownStart.setX(reader.readFloat());
+    crownStart.setY(reader.readFloat());
+
+    int wallCount = reader.readUInt16();
+    for (int i = 0; i < wallCount && reader.ok(); i++)
+    {
+        MapWall wall;
+        wall.outline = reader.readUInt32();
+        wall.corners = readPoints(reader);
+        if (wall.corners.size() < MIN_WALL_CORNERS)
+        {
+            return false;
+        }
+        walls.append(wall);
+    }
+
+    spawns = readPoints(reader);
+
+    int waveCount = reader.readUInt16();
+    for (int i = 0; i < waveCount && reader.ok(); i++)
+    {
+        healthKitWaves.append(readPoints(reader));
+    }
+
+    return reader.ok() && width > 0 && height > 0;
+}
+
+QByteArray MapData::toBinary() const
+{
+    QByteArray data;
+    BinaryWriter writer(data);
+
+    writer.writeUInt32(MAP_FILE_MAGIC);
+    writer.writeUInt8(MAP_FILE_VERSION);
+    write(writer);
+
+    return data;
+}
+
+QString MapData::toText() const
+{
+    QStringList lines;
+
+    if (!name.isEmpty())
+    {
+        lines << QStringLiteral("name %1").arg(name);
+    }
+    lines << QStringLiteral("size %1 %2").arg(width).arg(height);
+    lines << QStringLiteral("crown %1 %2").arg(crownStart.x()).arg(crownStart.y());
+
+    for (QPointF const& spawn : spawns)
+    {
+        lines << QStringLiteral("spawn %1 %2").arg(spawn.x()).arg(spawn.y());
+    }
+
+    for (QVector<QPointF> const& wave : healthKitWaves)
+    {
+        lines << QStringLiteral("health %1").arg(pointsToText(wave));
+    }
+
+    for (MapWall const& wall : walls)
+    {
+        lines << QStringLiteral("wall %1 %2").arg(colorToText(wall.outline), pointsToText(wall.corners));
+    }
+
+    return lines.join(QLatin1Char('\n')) + QLatin1Char('\n');
+}
+
+bool MapData::fromBinary(QByteArray const& data, MapData& map)
+{
+    BinaryReader reader(data);
+
+    quint32 magic = reader.readUInt32();
+    quint8 version = reader.readUInt8();
+    if (!reader.ok() || magic != MAP_FILE_MAGIC || version != MAP_FILE_VERSION)
+    {
+        return false;
+    }
+
+    return map.read(reader);
+}
+
+bool MapData::fromText(QString const& text, MapData& map, QString* error)
+{
+    static QRegularExpression const whitespace(QStringLiteral("\\s+"));
+
+    MapData parsed;
+    QStringList const lines = text.split(QLatin1Char('\n'));
+
+    for (int i = 0; i < lines.size(); i++)
+    {
+        QString const line = lines[i].trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+        {
+            continue;
+        }
+
+        QStringList const tokens = line.split(whitespace);
+        QString const& keyword = tokens.first();
+        bool ok = true;
+
+        if (keyword == QLatin1String("name"))
+        {
+            parsed.name = line.mid(keyword.size()).trimmed();
+        }
+        else if (keyword == QLatin1String("size"))
+        {
+            QVector<QPointF> size;
+            ok = tokens.size() == 3 && parsePoints(tokens, 1, size) && size[0].x() > 0 && size[0].y() > 0;
+            if (ok)
+            {
+                parsed.width = size[0].x();
+                parsed.height = size[0].y();
+            }
+        }
+        else if (keyword == QLatin1String("crown"))
+        {
+            QVector<QPointF> crown;
+            ok = tokens.size() == 3 && parsePoints(tokens, 1, crown);
+            if (ok)
+            {
+                parsed.crownStart = crown[0];
+            }
+        }
+        else if (keyword == QLatin1String("spawn"))
+        {
+            ok = tokens.size() == 3 && parsePoints(tokens, 1, parsed.spawns);
+        }
+        else if (keyword == QLatin1String("health"))
+        {
+            QVector<QPointF> wave;
+            ok = parsePoints(tokens, 1, wave);
+            parsed.healthKitWaves.append(wave);
+        }
+        else if (keyword == QLatin1String("wall"))
+        {
+            MapWall wall;
+            ok = tokens.size() >= 2 && parseColor(tokens[1], wall.outline) && parsePoints(tokens, 2, wall.corners)
+                 && wall.corners.size() >= MIN_WALL_CORNERS;
+            parsed.walls.append(wall);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            if (error != nullptr)
+            {
+                *error = QStringLiteral("line %1: cannot read \"%2\"").arg(i + 1).arg(line);
+            }
+            return false;
+        }
+    }
+
+    map = parsed;
+    return true;
+}
+
+bool MapData::load(QString const& path, MapData& map)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Could not open map" << path;
+        return false;
+    }
+
+    // Read the file where it lies if it can be mapped, and in one read otherwise
+    uchar* mapped = file.map(0, file.size());
+    QByteArray const data = mapped != nullptr
+            ? QByteArray::fromRawData(reinterpret_cast<char const*>(mapped), static_cast<int>(file.size()))
+            : file.readAll();
+
+    bool loaded = false;
+    QString error;
+    if (data.size() >= 4 && BinaryReader(data).readUInt32() == MAP_FILE_MAGIC)
+    {
+        loaded = fromBinary(data, map);
+    }
+    else
+    {
+        loaded = fromText(QString::fromUtf8(data), map, &error);
+    }
+
+    if (mapped != nullptr)
+    {
+        file.unmap(mapped);
+    }
+
+    if (!loaded)
+    {
+        qWarning() << "Could not load map" << path << error;
+        return false;
+    }
+
+    qDebug() << "Loaded map" << path << "in" << timer.nsecsElapsed() / 1000 << "us";
+    return true;
+}
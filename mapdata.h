@@ -0,0 +1,137 @@
+#ifndef MAPDATA_H
+#define MAPDATA_H
+
+#include "binarystream.h"
+#include "settings.h"
+
+#include <QByteArray>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+/*!
+ * \brief The MapWall struct holds one wall of a map.
+ */
+struct MapWall
+{
+    /*!
+     * \brief The corners of the wall, in scene coordinates.
+     */
+    QVector<QPointF> corners;
+
+    /*!
+     * \brief The color the wall is outlined with, as 0xAARRGGBB.
+     */
+    quint32 outline = 0xffff0000;
+};
+
+/*!
+ * \brief The MapData struct holds everything that makes up a map: its size, walls, spawn points,
+ * health kit locations and where the crown starts.
+ *
+ * Maps are authored in a line-based text form:
+ *
+ *     # comments start with a hash
+ *     name Arena
+ *     size 1200 600
+ *     crown 550 300
+ *     spawn 500 400
+ *     health 200 175 525 525 725 75
+ *     wall #ff0000 0 0 50 25 50 282
+ *
+ * Every spawn line adds a spawn point, every health line adds a wave of health kits that appear
+ * together, and every wall line adds a wall with the given outline color and at least three
+ * corners. The same map can be converted to a compact binary form, which is what is sent over
+ * the network and what loads fastest.
+ */
+struct MapData
+{
+    QString name;
+
+    qreal width = MAP_WIDTH;
+    qreal height = MAP_HEIGHT;
+
+    /*!
+     * \brief The position of the top left corner of the crown at the start of a game.
+     */
+    QPointF crownStart;
+
+    QVector<MapWall> walls;
+    QVector<QPointF> spawns;
+
+    /*!
+     * \brief The positions of the top left corners of the health kits, one list per wave.
+     * Waves take turns.
+     */
+    QVector<QVector<QPointF>> healthKitWaves;
+
+    inline QRectF bounds() const
+    {
+        return QRectF(0, 0, width, height);
+    }
+
+    /*!
+     * \brief Returns a spawn point. There may be fewer spawn points than players, in which case
+     * they are shared.
+     * \param index the index of the spawn point, such as the number of the player's color
+     * \return the spawn point, or the middle of the map if the map has none
+     */
+    QPointF spawn(int index) const;
+
+    /*!
+     * \brief Returns the corners of every wall, in the form the world collides against.
+     */
+    QVector<QVector<QPointF>> wallCorners() const;
+
+    /*!
+     * \brief Writes the map in the fixed binary layout also used by the wire protocol.
+     * \param writer the writer to write the map to
+     */
+    void write(BinaryWriter& writer) const;
+
+    /*!
+     * \brief Reads a map that was written with write().
+     * \param reader the reader to read the map from
+     * \return whether or not the map was able to be read
+     */
+    bool read(BinaryReader& reader);
+
+    /*!
+     * \brief Returns the binary file form of the map.
+     */
+    QByteArray toBinary() const;
+
+    /*!
+     * \brief Returns the text form of the map.
+     */
+    QString toText() const;
+
+    /*!
+     * \brief Tries to read the binary file form of a map.
+     * \param data the contents of the file
+     * \param map the resulting map, if reading was successful
+     * \return whether or not the data was able to be read
+     */
+    static bool fromBinary(QByteArray const& data, MapData& map);
+
+    /*!
+     * \brief Tries to parse the text form of a map.
+     * \param text the contents of the file
+     * \param map the resulting map, if parsing was successful
+     * \param error set to the line and reason parsing failed, if it failed
+     * \return whether or not the text was able to be parsed
+     */
+    static bool fromText(QString const& text, MapData& map, QString* error = nullptr);
+
+    /*!
+     * \brief Loads a map file in either form. The file is mapped into memory rather than
+     * copied where possible, so a binary map is read straight from the mapped bytes.
+     * \param path the path of the file
+     * \param map the resulting map, if loading was successful
+     * \return whether or not the file was able to be loaded
+     */
+    static bool load(QString const& path, MapData& map);
+};
+
+#endif // MAPDATA_H
@@ -1,4 +1,9 @@
 #include "mapscene.h"
+#include "assetbundle.h"
+#include "texturecache.h"
+
+#include <QDebug>
+#include <QtMath>
 
 
 MapScene::MapScene(QObject* parent) :
@@ -7,104 +12,59 @@ MapScene::MapScene(QObject* parent) :
     // health spawner timer
     healthTimer = new QTimer(this);
     connect(healthTimer, SIGNAL(timeout()), this, SLOT(healthSpawner()));
-    healthTimer->start(15000);
+    healthTimer->start(HEALTH_KIT_WAVE_INTERVAL);
 
-    // create frame timer for advance()
+    // create frame timer for advance(). The timer only wakes the scene up; how many
+    //  advance frames to run is measured separately.
     advanceTimer = new QTimer(this);
-    connect(advanceTimer, SIGNAL(timeout()), this, SLOT(advance()));
-    advanceTimer->start(10);
-
-    // set scene rect and background
-    this->setSceneRect(0,0,MAP_WIDTH,MAP_HEIGHT);
-    QPixmap pm(":/images/floorTile.png");
-    this->setBackgroundBrush(QBrush(pm));
-
-    // set the pen and brush to fill in polygons
-    QPen redPen(Qt::red, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
-    QPen bluePen(Qt::blue, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
-    QPen greenPen(Qt::green, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
-    QBrush brush(Qt::black, Qt::SolidPattern);
-
+    advanceTimer->setTimerType(Qt::PreciseTimer);
+    connect(advanceTimer, SIGNAL(timeout()), this, SLOT(onFrame()));
+    _clock.start();
+    advanceTimer->start(FRAME_INTERVAL);
 
     //*******************************
     //QLabel *showTime = new QLabel;
     this->addSimpleText("Something");
 
-    /******************************************************* Create Left Wall *******************************************************/
-    // create left_wall and add to the scene
-    QPointF left_wall[13] = {QPointF(0,0), QPointF(50,25), QPointF(50,282), QPointF(81,332), QPointF(81,434),
-                             QPointF(50,484), QPointF(50,575), QPointF(0,600), QPointF(0,0)};
-    WallItem *leftWall = new WallItem(left_wall, 13, redPen, brush);
-    this->addItem(leftWall);
-    /******************************************************* Create Top Wall ********************************************************/
-    // create top_wall and add to the scene
-    QPointF top_wall[15] = {QPointF(0,0), QPointF(1200,0), QPointF(1150,25), QPointF(700,25), QPointF(700,125),
-                            QPointF(800,125), QPointF(774,145), QPointF(680,145), QPointF(680,25), QPointF(566,25),
-                            QPointF(516,63), QPointF(354,63), QPointF(304,25), QPointF(50,25), QPointF(0,0)};
-    WallItem *topWall = new WallItem(top_wall, 15, redPen, brush);
-    this->addItem(topWall);
-    /******************************************************* Create Right Wall ******************************************************/
-    // create right_wall and add to the scene
-    //optional points for jutting wall-->   QPointF(1150,477), QPointF(1049,477), QPointF(1069,457), QPointF(1150,457),
-    QPointF right_wall[5] = {QPointF(1200,0), QPointF(1200,600), QPointF(1150,575), QPointF(1150, 25), QPointF(1200,0)};
-    WallItem *rightWall = new WallItem(right_wall, 5, redPen, brush);
-    this->addItem(rightWall);
-    /******************************************************* Create Bottom Wall *****************************************************/
-    // create bottom_wall and add to the scene
-    QPointF bottom_wall[11] = {QPointF(0,600), QPointF(50,575), QPointF(580,575), QPointF(580,495), QPointF(480,495),
-                               QPointF(500,475), QPointF(600,475), QPointF(600,575), QPointF(1150,575), QPointF(1200,600),
-                               QPointF(0,600)};
-    WallItem *bottomWall = new WallItem(bottom_wall, 11, redPen, brush);
-    this->addItem(bottomWall);
-    /******************************************************* Create Inner Wall 1 ****************************************************/
-    // create inner_wall_1 and add to the scene
-    QPointF inner_wall_1[7] = {QPointF(160,230), QPointF(130,260), QPointF(287,260), QPointF(287,108), QPointF(257,138),
-                               QPointF(257,230), QPointF(160,230)};
-    WallItem *innerWall1 = new WallItem(inner_wall_1, 7, bluePen, brush);
-    this->addItem(innerWall1);
-    /******************************************************* Create Inner Wall 2 ****************************************************/
-    // create inner_wall_2 and add to the scene
-    QPointF inner_wall_2[9] = {QPointF(182,404), QPointF(182,499), QPointF(360,499), QPointF(360,404), QPointF(330, 434),
-                               QPointF(330,469), QPointF(212,469), QPointF(212,434), QPointF(182,404)};
-    WallItem *innerWall2 = new WallItem(inner_wall_2, 9, bluePen, brush);
-    this->addItem(innerWall2);
-    /******************************************************* Create Inner Wall 3 ****************************************************/
-    // create inner_wall_3 and add to the scene
-    QPointF inner_wall_3[9] = {QPointF(744,390), QPointF(744,485), QPointF(774,455), QPointF(774,420), QPointF(892,420),
-                               QPointF(892,455), QPointF(922,485), QPointF(922,390), QPointF(744,390)};
-    WallItem *innerWall3 = new WallItem(inner_wall_3, 9, bluePen, brush);
-    this->addItem(innerWall3);
-    /******************************************************* Create Inner Wall 4 ****************************************************/
-    // create inner_wall_4 and add to the scene
-    QPointF inner_wall_4[5] = {QPointF(989,146), QPointF(938,197), QPointF(989,248), QPointF(1040,197), QPointF(989,146)};
-    WallItem *innerWall4 = new WallItem(inner_wall_4, 5, bluePen, brush);
-    this->addItem(innerWall4);
-    /********************************************************************************************************************************/
+    // load the map, which sets the scene rect and bakes the background with the walls
+    MapData map;
+    if (!AssetBundle::instance().map(":/maps/arena.map", map) && !MapData::load(":/maps/arena.map", map))
+    {
+        qWarning() << "Starting without a map";
+    }
+    setMap(map);
 
     // test having all 8 players on screen
     createPlayers(DEFAULT_MAX_PLAYERS);
 
-    // create and add the crown to the scene
-    crown = new CrownItem;
-    addItem(crown);
+    // bullets are drawn with recycled items
+    _bulletPool = new BulletItemPool(this);
 
     // add respawn overlay
-    respawnOverlay = new RespawnOverlayItem;
+    respawnOverlay = new RespawnOverlayItem(&_animationClock);
     //addItem(respawnOverlay);
-    //respawnOverlay->rateTimer->start();
 
     // add game start overlay
-    gameStartOverlay = new GameStartOverlayItem;
+    gameStartOverlay = new GameStartOverlayItem(&_animationClock);
 
-    // respawn overlay timer
-    respawnTimer = new QTimer;
-    connect(respawnTimer, SIGNAL(timeout()), this, SLOT(checkIfPlayerDead()));
-    respawnTimer->start(16);
+    // create and add the crown to the scene
+    crown = new CrownItem;
+    addItem(crown);
+    _world.placeCrown(_map.crownStart);
+    syncItems(0.0);
 }
 
 MapScene::~MapScene()
 {
-    delete this;
+    // The overlays are only in the scene while they show, so the scene does not always own them
+    if (respawnOverlay->scene() != this)
+    {
+        delete respawnOverlay;
+    }
+    if (gameStartOverlay->scene() != this)
+    {
+        delete gameStartOverlay;
+    }
 }
 
 void MapScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -124,27 +84,49 @@ void MapScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
 
 void MapScene::keyPressEvent(QKeyEvent* event)
 {
-    // passes key press event to player
+    // passes key press event to player, and the keys it holds down to the world
     if (event != nullptr)
     {
         myPlayer()->keyPressEvent(event);
+        _world.setInput(_myPlayerColor, myPlayer()->input());
     }
     QGraphicsScene::keyPressEvent(event);
 }
 
 void MapScene::keyReleaseEvent(QKeyEvent* event)
 {
-    // passes key release event to player
+    // passes key release event to player, and the keys it holds down to the world
     if (event != nullptr)
     {
         myPlayer()->keyReleaseEvent(event);
+        _world.setInput(_myPlayerColor, myPlayer()->input());
     }
     QGraphicsScene::keyReleaseEvent(event);
 }
 
 void MapScene::setMyColor(PlayerColor color)
 {
+    // Only the local player's movement is predicted
+    if (_players.contains(_myPlayerColor))
+    {
+        _players[_myPlayerColor]->setLocallyControlled(false);
+    }
+    _world.setInput(_myPlayerColor, PlayerInput());
+
     _myPlayerColor = color;
+    _interpolationBuffers.remove(color);
+
+    if (_players.contains(color))
+    {
+        _players[color]->setLocallyControlled(true);
+        showRespawnOverlay(_players[color]->isDead());
+    }
+
+    // The local player is moved by the world, even if it was positioned from the network before
+    if (PlayerState* state = _world.player(color))
+    {
+        state->simulated = true;
+    }
 }
 
 void MapScene::createPlayers(int count)
@@ -156,8 +138,14 @@ void MapScene::createPlayers(int count)
         auto player = new PlayerItem(static_cast<PlayerColor>(i));
         _players[static_cast<PlayerColor>(i)] = player;
 
-        player->respawnPoint = spawns[i];
-        player->setPos(player->respawnPoint);
+        player->setPos(_map.spawn(i));
+        player->setLocallyControlled(player->color() == _myPlayerColor);
+        _world.addPlayer(player->color(), _map.spawn(i));
+
+        // local shots go through the same path as shots from the network
+        connect(player, &PlayerItem::shotBullet, this, &MapScene::onBulletUpdated);
+        connect(player, &PlayerItem::died, this, &MapScene::onPlayerDied);
+        connect(player, &PlayerItem::respawned, this, &MapScene::onPlayerRespawned);
 
         this->addItem(player);
         this->addItem(player->myHealthbar);
@@ -167,43 +155,287 @@ void MapScene::createPlayers(int count)
 
 void MapScene::onPositionUpdated(PlayerColor color, QPointF position)
 {
-    PlayerItem* player = _players[color];
-    player->setPos(position);
+    // The local player's own position is predicted instead
+    if (color == _myPlayerColor)
+    {
+        return;
+    }
+
+    _interpolationBuffers[color].addSample(_clock.elapsed(), position);
 }
 
 void MapScene::onBulletUpdated(PlayerColor color, QPointF source, qreal angle)
 {
-    PlayerItem* player = _players[color];
-    player->shoot(source, angle, true);
+    _world.spawnBullet(color, source, angle);
 }
 
 void MapScene::onHealthUpdated(PlayerColor color, int health, bool hasCrown)
 {
-    PlayerItem* player = _players[color];
-    player->setHealth(health);
-    player->setHasCrown(hasCrown);
+    _world.setPlayerHealth(color, health, hasCrown);
+}
+
+void MapScene::onSnapshotReceived(WorldSnapshot const& snapshot)
+{
+    if (PlayerSnapshot const* me = snapshot.player(_myPlayerColor))
+    {
+        QPointF correction = myPlayer()->reconcile(me->lastInput, me->position);
+        PlayerState* state = _world.player(_myPlayerColor);
+
+        if (state != nullptr && !correction.isNull())
+        {
+            state->position += correction;
+        }
+    }
+
+    // Snapshots are spaced evenly in server time, but not in arrival time. Map server time
+    //  onto the local clock using the smallest delay seen so far, which only creeps up
+    //  slowly in case the clocks drift apart.
+    qint64 offset = _clock.elapsed() - snapshot.time;
+    if (!_hasSnapshotClockOffset || offset < _snapshotClockOffset)
+    {
+        _snapshotClockOffset = offset;
+        _hasSnapshotClockOffset = true;
+    }
+    else
+    {
+        _snapshotClockOffset += (offset - _snapshotClockOffset) / 100;
+    }
+
+    for (PlayerSnapshot const& player : snapshot.players)
+    {
+        if (player.color != _myPlayerColor)
+        {
+            _interpolationBuffers[player.color].addSample(snapshot.time + _snapshotClockOffset, player.position);
+        }
+    }
+}
+
+void MapScene::updateRemotePlayers()
+{
+    qint64 renderTime = _clock.elapsed() - _interpolationDelay;
+
+    for (auto it = _interpolationBuffers.begin(); it != _interpolationBuffers.end(); ++it)
+    {
+        PlayerState const* player = _world.player(it.key());
+        if (player == nullptr || it.key() == _myPlayerColor || it->isEmpty())
+        {
+            continue;
+        }
+
+        // Do not slide dead players from where they died to where they respawn
+        if (player->isDead)
+        {
+            it->clear();
+            continue;
+        }
+
+        _world.setPlayerPosition(it.key(), it->position(renderTime));
+    }
+}
+
+void MapScene::onFrame()
+{
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    qint64 now = _clock.nsecsElapsed();
+    qint64 stepLength = SIMULATION_STEP * qint64(1000000);
+
+    _stepAccumulator += now - _lastFrameAt;
+    _lastFrameAt = now;
+
+    int steps = 0;
+    while (_stepAccumulator >= stepLength)
+    {
+        if (steps >= SIMULATION_MAX_CATCH_UP_STEPS)
+        {
+            // Drop the rest of the backlog instead of falling further behind
+            _droppedSteps += _stepAccumulator / stepLength;
+            _stepAccumulator %= stepLength;
+            break;
+        }
+
+        _world.step();
+        _stepAccumulator -= stepLength;
+        steps++;
+
+        // Remember where each advance frame predicted the local player to be
+        PlayerState const* me = _world.player(_myPlayerColor);
+        if (me != nullptr && !me->isDead)
+        {
+            myPlayer()->recordPrediction(me->position);
+        }
+    }
+
+    updateRemotePlayers();
+
+    // Draw players part of the way towards the next advance frame
+    syncItems(static_cast<qreal>(_stepAccumulator) / stepLength);
+
+    // Every sprite animation moves on with the frame, instead of on timers of its own
+    _animationClock.advance(_clock.elapsed());
+
+    _lastFrameSteps = steps;
+    _lastFrameTime = frameTimer.nsecsElapsed() / 1000;
+    _maxFrameTime = qMax(_maxFrameTime, _lastFrameTime);
+    _averageFrameTime += (_lastFrameTime - _averageFrameTime) * 0.05;
+
+    emit frameFinished();
+}
+
+void MapScene::syncItems(qreal alpha)
+{
+    for (PlayerState const& state : _world.players())
+    {
+        PlayerItem* player = _players.value(state.color);
+        if (player == nullptr)
+        {
+            continue;
+        }
+
+        player->setDead(state.isDead, _world.time());
+        player->setHealth(state.health);
+        if (player->hasCrown() != state.hasCrown)
+        {
+            player->setHasCrown(state.hasCrown);
+        }
+
+        player->setPos(state.position);
+        player->setRenderOffset((state.previousPosition - state.position) * (1.0 - alpha));
+    }
+
+    // Bullet items line up with the world's bullet slots. A slot whose bullet was replaced
+    //  keeps its item; only the items of emptied slots go back to the pool.
+    ProjectileSystem const& bullets = _world.bullets();
+    if (_bulletItems.size() < bullets.capacity())
+    {
+        _bulletItems.resize(bullets.capacity());
+        _bulletItemIds.resize(bullets.capacity());
+    }
+
+    for (int slot = 0; slot < _bulletItems.size(); slot++)
+    {
+        BulletItem*& item = _bulletItems[slot];
+
+        if (slot >= bullets.capacity() || !bullets.isAlive(slot))
+        {
+            if (item != nullptr)
+            {
+                _bulletPool->release(item);
+                item = nullptr;
+            }
+            continue;
+        }
+
+        if (item == nullptr || _bulletItemIds[slot] != bullets.id(slot))
+        {
+            if (item == nullptr)
+            {
+                item = _bulletPool->acquire();
+            }
+
+            _bulletItemIds[slot] = bullets.id(slot);
+            item->setRotation(bullets.angle(slot)); // rotate the bullet to match angle that it's fired
+        }
+        item->setPos(bullets.position(slot));
+    }
+
+    // Same for health kits
+    QSet<quint32> liveHealthKits;
+    for (PickupState const& healthKit : _world.healthKits())
+    {
+        liveHealthKits.insert(healthKit.id);
+
+        if (!_healthKitItems.contains(healthKit.id))
+        {
+            HealthItem* item = new HealthItem(healthKit.position.x(), healthKit.position.y(), &_animationClock);
+            _healthKitItems.insert(healthKit.id, item);
+            addItem(item);
+        }
+    }
+
+    for (auto it = _healthKitItems.begin(); it != _healthKitItems.end(); )
+    {
+        if (liveHealthKits.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+
+        removeHealthKit(it.value());
+        it = _healthKitItems.erase(it);
+    }
+
+    crown->setVisible(_world.isCrownPlaced());
+    crown->setPos(_world.crownPosition());
+}
+
+void MapScene::setMap(MapData const& map)
+{
+    _map = map;
+
+    // set scene rect. The background is drawn from the static layer baked with the walls.
+    this->setSceneRect(_map.bounds());
+
+    _world.loadMap(_map);
+    createWalls();
+}
+
+void MapScene::setInterpolationDelay(int value)
+{
+    _interpolationDelay = qMax(0, value);
+}
+
+void MapScene::onPlayerDied(PlayerColor color, qint64 time)
+{
+    Q_UNUSED(time);
+
+    PlayerItem* player = _players.value(color);
+    if (player != nullptr && player->isLocallyControlled())
+    {
+        emit healthChanged(color, 0, false);
+    }
+
+    if (color == _myPlayerColor)
+    {
+        showRespawnOverlay(true);
+    }
+}
+
+void MapScene::onPlayerRespawned(PlayerColor color, qint64 time)
+{
+    Q_UNUSED(time);
+
+    PlayerItem* player = _players.value(color);
+    if (player != nullptr && player->isLocallyControlled())
+    {
+        emit healthChanged(color, PLAYER_MAX_HEALTH, player->hasCrown());
+    }
+
+    if (color == _myPlayerColor)
+    {
+        showRespawnOverlay(false);
+    }
 }
 
-void MapScene::checkIfPlayerDead()
+void MapScene::showRespawnOverlay(bool value)
 {
-    static int checkNum = 1;    // Static variable to ensure that the timer only starts once
-    if (myPlayer()->isDead && checkNum == 1)
+    if (value)
     {
-        checkNum = 0;   // Set static int to a value other than the one to start the timer
-        respawnOverlay->ResetIndex();
-        addItem(respawnOverlay);    // Add respawn overlay to the scene
-        respawnOverlay->rateTimer->start(); // Start the timer
+        if (respawnOverlay->scene() != this)
+        {
+            addItem(respawnOverlay);    // Add respawn overlay to the scene
+        }
+        respawnOverlay->start();    // Count down from the moment of death
     }
-    else if (myPlayer()->isDead == false)
-    {  // Check if player is no longer dead
-        respawnOverlay->rateTimer->stop();  // Stop the timer
-        //respawnOverlay->ResetIndex();
+    else
+    {
+        respawnOverlay->stop();
 
         if (respawnOverlay->scene() == this)
         {
-            this->removeItem(respawnOverlay);     // Remove timer from the scene
+            this->removeItem(respawnOverlay);     // Remove overlay from the scene
         }
-        checkNum = 1;   // Reset static int
     }
 }
 
@@ -225,101 +457,79 @@ void MapScene::removeHealthKit(HealthItem* item)
 void MapScene::mapSetup()
 {
     // health spawner timer
-    healthTimer->start(15000);
+    healthTimer->start(HEALTH_KIT_WAVE_INTERVAL);
 
     // create frame timer for advance()
-    advanceTimer->start(10);
+    _stepAccumulator = 0;
+    _lastFrameAt = _clock.nsecsElapsed();
+    advanceTimer->start(FRAME_INTERVAL);
+
+    // Reset player positions and health, take away the crown and put it back where it starts.
+    //  The map itself stays as it was loaded.
+    _world.reset();
+    _world.placeCrown(_map.crownStart);
+    for (PlayerItem* player : _players)
+    {
+        player->reset();
+    }
+    _interpolationBuffers.clear();
+    syncItems(0.0);
+}
 
-    // set scene rect and background
-    this->setSceneRect(0,0,MAP_WIDTH,MAP_HEIGHT);
-    QPixmap pm(":/images/floorTile.png");
-    this->setBackgroundBrush(QBrush(pm));
+void MapScene::createWalls()
+{
+    // remove the walls of the previous map
+    for (WallItem* wall : qAsConst(_wallItems))
+    {
+        delete wall;
+    }
+    _wallItems.clear();
 
-    // set the pen and brush to fill in polygons
-    QPen redPen(Qt::red, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
-    QPen bluePen(Qt::blue, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
-    QPen greenPen(Qt::green, 4, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
+    // every wall is filled black and outlined in the color the map gives it
     QBrush brush(Qt::black, Qt::SolidPattern);
+    for (MapWall const& wall : _map.walls)
+    {
+        QPen pen(QColor::fromRgba(wall.outline), WALL_OUTLINE_WIDTH, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
+        QVector<QPointF> corners = wall.corners;
 
+        _wallItems.append(new WallItem(corners.data(), corners.size(), pen, brush));
+    }
 
-    //*******************************
-    //QLabel *showTime = new QLabel;
-    this->addSimpleText("Something");
+    bakeStaticLayer();
+}
 
-    /******************************************************* Create Left Wall *******************************************************/
-    // create left_wall and add to the scene
-    QPointF left_wall[13] = {QPointF(0,0), QPointF(50,25), QPointF(50,282), QPointF(81,332), QPointF(81,434),
-                             QPointF(50,484), QPointF(50,575), QPointF(0,600), QPointF(0,0)};
-    WallItem *leftWall = new WallItem(left_wall, 13, redPen, brush);
-    this->addItem(leftWall);
-    /******************************************************* Create Top Wall ********************************************************/
-    // create top_wall and add to the scene
-    QPointF top_wall[15] = {QPointF(0,0), QPointF(1200,0), QPointF(1150,25), QPointF(700,25), QPointF(700,125),
-                            QPointF(800,125), QPointF(774,145), QPointF(680,145), QPointF(680,25), QPointF(566,25),
-                            QPointF(516,63), QPointF(354,63), QPointF(304,25), QPointF(50,25), QPointF(0,0)};
-    WallItem *topWall = new WallItem(top_wall, 15, redPen, brush);
-    this->addItem(topWall);
-    /******************************************************* Create Right Wall ******************************************************/
-    // create right_wall and add to the scene
-    //optional points for jutting wall-->   QPointF(1150,477), QPointF(1049,477), QPointF(1069,457), QPointF(1150,457),
-    QPointF right_wall[5] = {QPointF(1200,0), QPointF(1200,600), QPointF(1150,575), QPointF(1150, 25), QPointF(1200,0)};
-    WallItem *rightWall = new WallItem(right_wall, 5, redPen, brush);
-    this->addItem(rightWall);
-    /******************************************************* Create Bottom Wall *****************************************************/
-    // create bottom_wall and add to the scene
-    QPointF bottom_wall[11] = {QPointF(0,600), QPointF(50,575), QPointF(580,575), QPointF(580,495), QPointF(480,495),
-                               QPointF(500,475), QPointF(600,475), QPointF(600,575), QPointF(1150,575), QPointF(1200,600),
-                               QPointF(0,600)};
-    WallItem *bottomWall = new WallItem(bottom_wall, 11, redPen, brush);
-    this->addItem(bottomWall);
-    /******************************************************* Create Inner Wall 1 ****************************************************/
-    // create inner_wall_1 and add to the scene
-    QPointF inner_wall_1[7] = {QPointF(160,230), QPointF(130,260), QPointF(287,260), QPointF(287,108), QPointF(257,138),
-                               QPointF(257,230), QPointF(160,230)};
-    WallItem *innerWall1 = new WallItem(inner_wall_1, 7, bluePen, brush);
-    this->addItem(innerWall1);
-    /******************************************************* Create Inner Wall 2 ****************************************************/
-    // create inner_wall_2 and add to the scene
-    QPointF inner_wall_2[9] = {QPointF(182,404), QPointF(182,499), QPointF(360,499), QPointF(360,404), QPointF(330, 434),
-                               QPointF(330,469), QPointF(212,469), QPointF(212,434), QPointF(182,404)};
-    WallItem *innerWall2 = new WallItem(inner_wall_2, 9, bluePen, brush);
-    this->addItem(innerWall2);
-    /******************************************************* Create Inner Wall 3 ****************************************************/
-    // create inner_wall_3 and add to the scene
-    QPointF inner_wall_3[9] = {QPointF(744,390), QPointF(744,485), QPointF(774,455), QPointF(774,420), QPointF(892,420),
-                               QPointF(892,455), QPointF(922,485), QPointF(922,390), QPointF(744,390)};
-    WallItem *innerWall3 = new WallItem(inner_wall_3, 9, bluePen, brush);
-    this->addItem(innerWall3);
-    /******************************************************* Create Inner Wall 4 ****************************************************/
-    // create inner_wall_4 and add to the scene
-    QPointF inner_wall_4[5] = {QPointF(989,146), QPointF(938,197), QPointF(989,248), QPointF(1040,197), QPointF(989,146)};
-    WallItem *innerWall4 = new WallItem(inner_wall_4, 5, bluePen, brush);
-    this->addItem(innerWall4);
-    /********************************************************************************************************************************/
-
-    // Reset player positions and health, and take away crown
-    for (PlayerItem* player : _players)
-    {
-        player->reset();
-    }
+void MapScene::bakeStaticLayer()
+{
+    _staticLayer = QPixmap(qCeil(_map.width), qCeil(_map.height));
 
-    // create and add the crown to the scene
-    if (crown == nullptr)
+    QPainter painter(&_staticLayer);
+    painter.fillRect(_staticLayer.rect(), TextureCache::instance().brush(":/images/floorTile.png"));
+
+    // The antialiased outlines are the most expensive part of the map to draw, which is
+    //  why they are only drawn here
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (WallItem* wall : qAsConst(_wallItems))
     {
-        crown->scene()->removeItem(crown);
-        delete crown;
+        painter.setPen(wall->pen());
+        painter.setBrush(wall->brush());
+        painter.drawPolygon(wall->polygon());
     }
-    crown = new CrownItem;
-    addItem(crown);
+    painter.end();
+
+    // Throw away any copy of the old background that a view has cached
+    invalidate(sceneRect(), QGraphicsScene::BackgroundLayer);
+}
 
-    // respawn overlay timer
-    respawnTimer->start(16);
+void MapScene::drawBackground(QPainter* painter, QRectF const& rect)
+{
+    // The static layer covers the scene rect, which starts at the origin
+    painter->drawPixmap(rect, _staticLayer, rect);
 }
 
 void MapScene::runGameStartOverlay()
 {
     this->addItem(gameStartOverlay);
-    this->gameStartOverlay->rateTimer->start();
+    this->gameStartOverlay->start();
 }
 
 void MapScene::healthSpawner()
@@ -328,34 +538,15 @@ void MapScene::healthSpawner()
     static int count = 0;
 
     // remove old health kits before adding new ones
-    if (count > 0)
-    {
-        removeHealthKit(healthKit);
-        removeHealthKit(healthKit2);
-        removeHealthKit(healthKit3);
-    }
+    _world.clearHealthKits();
 
-    if (count % 2 == 0)
+    // the map's waves of health kits take turns
+    if (!_map.healthKitWaves.isEmpty())
     {
-        // create health items at position 1
-        healthKit = new HealthItem(200,175);
-        healthKit2 = new HealthItem(525,525);
-        healthKit3 = new HealthItem(725,75);
-        // add health kits to the scene after position has been set
-        addItem(healthKit);
-        addItem(healthKit2);
-        addItem(healthKit3);
-    }
-    else
-    {
-        // create health items at position 2
-        healthKit = new HealthItem(225,300);
-        healthKit2 = new HealthItem(925,300);
-        healthKit3 = new HealthItem(575,50);
-        // add health kits to the scene after position has been set
-        addItem(healthKit);
-        addItem(healthKit2);
-        addItem(healthKit3);
+        for (QPointF const& position : _map.healthKitWaves[count % _map.healthKitWaves.size()])
+        {
+            _world.spawnHealthKit(position);
+        }
     }
 
     count++;
@@ -3,6 +3,7 @@
 
 #include "playeritem.h"
 #include "wallitem.h"
+#include "bulletitempool.h"
 #include "crownitem.h"
 #include "healthitem.h"
 #include "configdialog.h"
@@ -11,13 +12,23 @@
 #include "settings.h"
 #include "respawnoverlayitem.h"
 #include "gamestartoverlayitem.h"
+#include "interpolationbuffer.h"
+#include "worldsnapshot.h"
+#include "gameworld.h"
+#include "mapdata.h"
+#include "animationclock.h"
 
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QMouseEvent>
 #include <QObject>
+#include <QPainter>
+#include <QPixmap>
 #include <QAbstractSocket>
+#include <QHash>
+#include <QSet>
 
 
 /*!
@@ -78,6 +89,22 @@ public:
 
     PlayerItem* winner;
 
+    /*!
+     * \brief Gets the simulated state of the game, which every item in the scene mirrors
+     */
+    inline GameWorld const& world() const
+    {
+        return _world;
+    }
+
+    /*!
+     * \brief Gets the map being played
+     */
+    inline MapData const& map() const
+    {
+        return _map;
+    }
+
     /*!
      * \brief Function called to initialize the MapScene at the beginning of a new game
      */
@@ -86,6 +113,82 @@ public:
 
     void runGameStartOverlay();
 
+    /*!
+     * \brief Gets how far (in milliseconds) remote players are drawn behind the newest position received for them
+     * \return the interpolation delay
+     */
+    inline int interpolationDelay() const
+    {
+        return _interpolationDelay;
+    }
+
+    /*!
+     * \brief Sets how far (in milliseconds) remote players are drawn behind the newest position received for them.
+     * Longer delays hide more network jitter at the cost of showing remote players further in the past.
+     * \param value the interpolation delay
+     */
+    void setInterpolationDelay(int value);
+
+    /*!
+     * \brief Gets how long the last frame took to simulate, in microseconds
+     */
+    inline qint64 lastFrameTime() const
+    {
+        return _lastFrameTime;
+    }
+
+    /*!
+     * \brief Gets the moving average of how long frames take to simulate, in microseconds
+     */
+    inline qint64 averageFrameTime() const
+    {
+        return static_cast<qint64>(_averageFrameTime);
+    }
+
+    /*!
+     * \brief Gets the longest any frame has taken to simulate, in microseconds
+     */
+    inline qint64 maxFrameTime() const
+    {
+        return _maxFrameTime;
+    }
+
+    /*!
+     * \brief Gets the number of advance frames the last frame ran
+     */
+    inline int lastFrameSteps() const
+    {
+        return _lastFrameSteps;
+    }
+
+    /*!
+     * \brief Gets the number of advance frames skipped because the game fell too far behind
+     */
+    inline qint64 droppedSteps() const
+    {
+        return _droppedSteps;
+    }
+
+    /*!
+     * \brief Gets the pool of items that bullets are drawn with, for its reuse statistics
+     */
+    inline BulletItemPool const* bulletPool() const
+    {
+        return _bulletPool;
+    }
+
+signals:
+    /*!
+     * \brief Emitted after every frame, once every item has been moved for it.
+     */
+    void frameFinished();
+
+    /*!
+     * \brief Emitted when a locally controlled player dies or respawns, for the network to
+     * tell the other players. Matches sendHealthUpdate of NetworkHost and NetworkClient.
+     */
+    void healthChanged(PlayerColor color, int health, bool hasCrown);
+
 public slots:
     /*!
      * \brief Function that randomly spawns health kits.
@@ -93,62 +196,165 @@ public slots:
     virtual void healthSpawner();
 
     /*!
-     * \brief Checks if player is dead, and handles respawn overlay.
+     * \brief Starts the respawn countdown if the player is the local player, and tells the
+     * network if the player is locally controlled.
+     */
+    void onPlayerDied(PlayerColor color, qint64 time);
+
+    /*!
+     * \brief Hides the respawn countdown if the player is the local player, and tells the
+     * network if the player is locally controlled.
      */
-    virtual void checkIfPlayerDead();
+    void onPlayerRespawned(PlayerColor color, qint64 time);
 
     void setMyColor(PlayerColor value);
+
+    /*!
+     * \brief Buffers a remote player's position as of the time it was received. This is meant for
+     * positions that do not arrive as part of a snapshot, such as on the host.
+     * \param color the color of the player
+     * \param position the new position of the player
+     */
     void onPositionUpdated(PlayerColor color, QPointF position);
+    /*!
+     * \brief Fires a bullet in the world, whether it was shot locally or received from the network
+     */
     void onBulletUpdated(PlayerColor color, QPointF source, qreal angle);
     void onHealthUpdated(PlayerColor color, int health, bool hasCrown);
 
+    /*!
+     * \brief Reconciles the predicted position of the local player with the host's snapshot,
+     * and buffers the positions of remote players as of the snapshot's server time.
+     * \param snapshot the state of the world received from the host
+     */
+    void onSnapshotReceived(WorldSnapshot const& snapshot);
+
+    /*!
+     * \brief Switches to another map, such as the one the host sends on joining. Players move
+     * to the new spawn points when the next game starts.
+     * \param map the map to play
+     */
+    void setMap(MapData const& map);
+
+    /*!
+     * \brief Moves every remote player to its interpolated position for the current frame.
+     */
+    void updateRemotePlayers();
+
+    /*!
+     * \brief Runs as many fixed-length advance frames as real time has passed since the last
+     * frame, then positions every player for drawing.
+     */
+    void onFrame();
+
+protected:
+    /*!
+     * \brief Draws the floor and walls from the static layer.
+     */
+    void drawBackground(QPainter* painter, QRectF const& rect) override;
+
 private:
     /*!
      * \brief Creates and adds players to the MapScene.
      */
     void createPlayers(int count);
 
-    PlayerColor _myPlayerColor = PlayerColor::Cyan;
+    /*!
+     * \brief Replaces the wall items with the walls of the map, and bakes them into the static layer.
+     */
+    void createWalls();
 
-    QMap<PlayerColor, PlayerItem*> _players;
+    /*!
+     * \brief Draws the floor and every wall into the static layer, and makes views draw it again.
+     */
+    void bakeStaticLayer();
 
-    QPointF const spawns[DEFAULT_MAX_PLAYERS] =
-        {
-            QPointF(500,400),
-            QPointF(500,200),
-            QPointF(650,350),
-            QPointF(600,200),
-            QPointF(600,400),
-            QPointF(450,250),
-            QPointF(450,350),
-            QPointF(650,250),
-        };
+    /*!
+     * \brief Shows and starts the respawn overlay, or stops and hides it.
+     */
+    void showRespawnOverlay(bool value);
 
-    QTimer *healthTimer;
+    /*!
+     * \brief Updates every item in the scene to match the world, adding and removing
+     * bullet and health kit items as they appear and disappear.
+     * \param alpha how far (0 to 1) the current frame is between the last advance frame and the next
+     */
+    void syncItems(qreal alpha);
 
-    QTimer *advanceTimer;
+    /*!
+     * \brief The game simulation that the scene draws
+     */
+    GameWorld _world;
 
-    QTimer* respawnTimer;
+    /*!
+     * \brief Ticks every sprite animation once per frame
+     */
+    AnimationClock _animationClock;
 
     /*!
-     * \brief Test crown for demonstration purposes.
+     * \brief The walls of the map. They are not added to the scene, but drawn into the static layer.
      */
-    CrownItem* crown;
+    QVector<WallItem*> _wallItems;
 
     /*!
-     * \brief Test healthkit for demonstration purposes.
+     * \brief Everything that never changes during a game, drawn once when the map is created
      */
-    HealthItem* healthKit;
+    QPixmap _staticLayer;
+    /*!
+     * \brief The item drawing the bullet in each of the world's bullet slots, and the id of that bullet
+     */
+    QVector<BulletItem*> _bulletItems;
+    QVector<quint32> _bulletItemIds;
+    BulletItemPool* _bulletPool;
+    QHash<quint32, HealthItem*> _healthKitItems;
+
+    PlayerColor _myPlayerColor = PlayerColor::Cyan;
+
+    QMap<PlayerColor, PlayerItem*> _players;
 
     /*!
-     * \brief Test healthkit for demonstration purposes.
+     * \brief Recently received positions of each remote player
      */
-    HealthItem* healthKit2;
+    QMap<PlayerColor, InterpolationBuffer> _interpolationBuffers;
 
     /*!
-     * \brief Test healthkit for demonstration purposes.
+     * \brief Clock that received positions are timestamped with
      */
-    HealthItem* healthKit3;
+    QElapsedTimer _clock;
+
+    /*!
+     * \brief Estimated difference between the local clock and the host's snapshot clock
+     */
+    qint64 _snapshotClockOffset = 0;
+    bool _hasSnapshotClockOffset = false;
+
+    int _interpolationDelay = INTERPOLATION_DELAY;
+
+    /*!
+     * \brief Time (in nanoseconds) not yet simulated by an advance frame
+     */
+    qint64 _stepAccumulator = 0;
+    qint64 _lastFrameAt = 0;
+
+    qint64 _lastFrameTime = 0;
+    double _averageFrameTime = 0.0;
+    qint64 _maxFrameTime = 0;
+    int _lastFrameSteps = 0;
+    qint64 _droppedSteps = 0;
+
+    /*!
+     * \brief The map being played: its walls, spawn points, health kit waves and crown start
+     */
+    MapData _map;
+
+    QTimer *healthTimer;
+
+    QTimer *advanceTimer;
+
+    /*!
+     * \brief The crown, shown while it waits in the middle of the map to be picked up.
+     */
+    CrownItem* crown;
 
     /*!
      * \brief Test respawn overlay.
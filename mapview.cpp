@@ -0,0 +1,85 @@
+#include "mapview.h"
+
+#include <QTimer>
+
+MapView::MapView(MapScene* scene, QWidget* parent) :
+    QGraphicsView(scene, parent)
+{
+    // The static layer never changes during a game, so keep a copy of it scaled to the viewport
+    setCacheMode(QGraphicsView::CacheBackground);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+
+    connect(scene, &QGraphicsScene::changed, this, &MapView::onSceneChanged);
+    connect(scene, &MapScene::frameFinished, this, &MapView::onFrameFinished);
+
+    setDirtyRegionMode(true);
+}
+
+void MapView::setDirtyRegionMode(bool value)
+{
+    _dirtyRegionMode = value;
+    _dirtyRegion = QRegion();
+
+    // Without any viewport updates of its own, the view only repaints what onFrameFinished asks for
+    setViewportUpdateMode(value ? QGraphicsView::NoViewportUpdate : QGraphicsView::MinimalViewportUpdate);
+    viewport()->update();
+}
+
+void MapView::onSceneChanged(QList<QRectF> const& rects)
+{
+    if (!_dirtyRegionMode)
+    {
+        return;
+    }
+
+    for (QRectF const& rect : rects)
+    {
+        // Grow each rect by a pixel to cover antialiased edges
+        _dirtyRegion += mapFromScene(rect).boundingRect().adjusted(-1, -1, 1, 1);
+    }
+}
+
+void MapView::onFrameFinished()
+{
+    if (!_dirtyRegionMode || _flushPending)
+    {
+        return;
+    }
+
+    // Posted events, including the scene's change notifications, are all handled before timers fire
+    _flushPending = true;
+    QTimer::singleShot(0, this, &MapView::flushDirtyRegion);
+}
+
+void MapView::flushDirtyRegion()
+{
+    _flushPending = false;
+    if (!_dirtyRegionMode || _dirtyRegion.isEmpty())
+    {
+        return;
+    }
+
+    viewport()->update(_dirtyRegion);
+    _dirtyRegion = QRegion();
+}
+
+void MapView::paintEvent(QPaintEvent* event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QGraphicsView::paintEvent(event);
+
+    qint64 pixels = 0;
+    for (QRect const& rect : event->region())
+    {
+        pixels += static_cast<qint64>(rect.width()) * rect.height();
+    }
+
+    _lastPaintTime = timer.nsecsElapsed() / 1000;
+    _averagePaintTime += (_lastPaintTime - _averagePaintTime) * 0.05;
+    _lastPaintedPixels = pixels;
+    _totalPaintedPixels += pixels;
+    _paintCount++;
+}
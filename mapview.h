@@ -0,0 +1,125 @@
+#ifndef MAPVIEW_H
+#define MAPVIEW_H
+
+#include "mapscene.h"
+
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QList>
+#include <QPaintEvent>
+#include <QRectF>
+#include <QRegion>
+
+/*!
+ * \brief MapView draws a MapScene. In dirty region mode, which is the default, every change the
+ * scene makes between two frames is collected and the viewport is repainted once per frame, over
+ * only the rects that changed. Otherwise every change repaints as soon as Qt gets to it.
+ */
+class MapView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Constructs a view of a map.
+     * \param scene the map to draw
+     * \param parent the parent widget
+     */
+    explicit MapView(MapScene* scene, QWidget* parent = nullptr);
+
+    /*!
+     * \brief Gets whether repaints are collected and issued once per frame
+     */
+    inline bool dirtyRegionMode() const
+    {
+        return _dirtyRegionMode;
+    }
+
+    /*!
+     * \brief Sets whether repaints are collected and issued once per frame. The floor and
+     * walls are cached either way.
+     * \param value whether to collect repaints
+     */
+    void setDirtyRegionMode(bool value);
+
+    /*!
+     * \brief Gets how long the last repaint took, in microseconds
+     */
+    inline qint64 lastPaintTime() const
+    {
+        return _lastPaintTime;
+    }
+
+    /*!
+     * \brief Gets the moving average of how long repaints take, in microseconds
+     */
+    inline qint64 averagePaintTime() const
+    {
+        return static_cast<qint64>(_averagePaintTime);
+    }
+
+    /*!
+     * \brief Gets the number of pixels the last repaint covered
+     */
+    inline qint64 lastPaintedPixels() const
+    {
+        return _lastPaintedPixels;
+    }
+
+    /*!
+     * \brief Gets the number of pixels covered by every repaint so far
+     */
+    inline qint64 totalPaintedPixels() const
+    {
+        return _totalPaintedPixels;
+    }
+
+    /*!
+     * \brief Gets the number of repaints so far
+     */
+    inline qint64 paintCount() const
+    {
+        return _paintCount;
+    }
+
+protected:
+    /*!
+     * \brief Repaints the viewport, and measures how long that took and how much was painted.
+     */
+    void paintEvent(QPaintEvent* event) override;
+
+private slots:
+    /*!
+     * \brief Adds rects of the scene that changed to the region repainted on the next frame.
+     * \param rects the changed rects, in scene coordinates
+     */
+    void onSceneChanged(QList<QRectF> const& rects);
+
+    /*!
+     * \brief Schedules the repaint of the frame the scene just finished. The scene only reports
+     * what changed once control returns to the event loop, so the repaint waits until then.
+     */
+    void onFrameFinished();
+
+    /*!
+     * \brief Repaints everything that changed since the last repaint, at once.
+     */
+    void flushDirtyRegion();
+
+private:
+    bool _dirtyRegionMode = false;
+
+    /*!
+     * \brief Part of the viewport to repaint on the next frame
+     */
+    QRegion _dirtyRegion;
+    bool _flushPending = false;
+
+    qint64 _lastPaintTime = 0;
+    double _averagePaintTime = 0.0;
+    qint64 _lastPaintedPixels = 0;
+    qint64 _totalPaintedPixels = 0;
+    qint64 _paintCount = 0;
+};
+
+#endif // MAPVIEW_H
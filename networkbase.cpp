@@ -1,371 +1,907 @@
 #include "networkbase.h"
+#include "binarystream.h"
+
+namespace
+{
+    /*!
+     * \brief The first byte of every binary payload. JSON payloads always begin with '{',
+     * so this byte is enough to tell the two wire formats apart.
+     */
+    const char BINARY_MAGIC = char(0xB1);
+}
 
 NetworkBase::NetworkBase(QObject* parent)
     : QObject(parent)
+    , _flushTimer(new QTimer(this))
+    , _flushLatencyHistogram(FLUSH_LATENCY_BUCKET_COUNT, 0)
+    , _datagramSocket(new QUdpSocket(this))
+{
+    _clock.start();
+
+    // Flush outbound queues once per network tick
+    _flushTimer->setInterval(NETWORK_UPDATE_RATE);
+    connect(_flushTimer, &QTimer::timeout, this, qOverload<>(&NetworkBase::flushOutbound));
+
+    connect(_datagramSocket, &QUdpSocket::readyRead, this, &NetworkBase::onDatagramsReady);
+}
+
+void NetworkBase::sendMessage(QAbstractSocket* socket, Message const& message)
+{
+    queueFrame(socket, message.type, message.color, frame(encode(message, wireFormat(socket))));
+}
+
+void NetworkBase::queueFrame(QAbstractSocket* socket, MessageType type, PlayerColor color, QByteArray const& framed)
+{
+    QVector<QueuedFrame>& queue = _outboundQueues[socket];
+    qint64 now = _clock.elapsed();
+
+    // Only the latest position of each player, and the latest snapshot or acknowledgement,
+    //  are worth sending
+    if (type == MessageType::POSITION_UPDATE || type == MessageType::WORLD_SNAPSHOT || type == MessageType::SNAPSHOT_ACK)
+    {
+        for (QueuedFrame& queued : queue)
+        {
+            if (queued.type == type && queued.color == color)
+            {
+                queued.framed = framed;
+                queued.queuedAt = now;
+                _coalescedMessages++;
+                return;
+            }
+        }
+    }
+
+    queue.append({ type, color, framed, now });
+
+    if (!_flushTimer->isActive())
+    {
+        _flushTimer->start();
+    }
+}
+
+void NetworkBase::flushOutbound(QAbstractSocket* socket)
+{
+    QVector<QueuedFrame> queue = _outboundQueues.take(socket);
+    if (queue.isEmpty())
+    {
+        return;
+    }
+
+    qint64 now = _clock.elapsed();
+
+    int size = 0;
+    for (QueuedFrame const& queued : queue)
+    {
+        size += queued.framed.size();
+    }
+
+    // Concatenate the frames so the whole tick goes out in a single write. If the peer has
+    //  a UDP endpoint, the unreliable messages of the tick go out as datagrams instead, split
+    //  so that none is larger than DATAGRAM_MAX_SIZE.
+    bool useDatagram = _datagramPeers.contains(socket);
+
+    QByteArray batch;
+    batch.reserve(size);
+
+    QVector<QByteArray> datagrams;
+    int const headerSize = static_cast<int>(sizeof(quint32));
+    int const lengthSize = static_cast<int>(sizeof(quint16));
+
+    // Every datagram of one flush carries the same sequence number, since together they
+    //  are the newest state as of this tick
+    quint32 sequence = useDatagram ? ++_datagramPeers[socket].sentSequence : 0;
+
+    for (QueuedFrame const& queued : queue)
+    {
+        // Datagrams are already delimited, so the 32 bit stream length prefix is
+        //  replaced by a 16 bit one
+        int payloadSize = queued.framed.size() - headerSize;
+
+        if (useDatagram && isUnreliable(queued.type) && headerSize + lengthSize + payloadSize <= DATAGRAM_MAX_SIZE)
+        {
+            if (datagrams.isEmpty() || datagrams.last().size() + lengthSize + payloadSize > DATAGRAM_MAX_SIZE)
+            {
+                datagrams.append(QByteArray());
+                datagrams.last().reserve(DATAGRAM_MAX_SIZE);
+                BinaryWriter(datagrams.last()).writeUInt32(sequence);
+            }
+
+            QByteArray& datagram = datagrams.last();
+            BinaryWriter(datagram).writeUInt16(static_cast<quint16>(payloadSize));
+            datagram.append(queued.framed.constData() + headerSize, payloadSize);
+        }
+        else
+        {
+            // Whatever does not fit in a datagram goes out reliably instead of being cut short
+            if (useDatagram && isUnreliable(queued.type))
+            {
+                _oversizeDatagramPayloads++;
+            }
+
+            batch.append(queued.framed);
+        }
+
+        int bucket = static_cast<int>((now - queued.queuedAt) / FLUSH_LATENCY_BUCKET_SIZE);
+        _flushLatencyHistogram[qMin(bucket, FLUSH_LATENCY_BUCKET_COUNT - 1)]++;
+    }
+
+    if (!datagrams.isEmpty())
+    {
+        DatagramPeer const& peer = _datagramPeers[socket];
+        for (QByteArray const& datagram : qAsConst(datagrams))
+        {
+            _datagramSocket->writeDatagram(datagram, peer.address, peer.port);
+        }
+    }
+
+    if (!batch.isEmpty() && socket->state() == QAbstractSocket::ConnectedState)
+    {
+        socket->write(batch);
+    }
+}
+
+void NetworkBase::flushOutbound()
 {
+    QList<QAbstractSocket*> const sockets = _outboundQueues.keys();
+    for (QAbstractSocket* socket : sockets)
+    {
+        flushOutbound(socket);
+    }
 
+    // Stop ticking while there is nothing to send
+    _flushTimer->stop();
 }
 
-void NetworkBase::sendMessage(QAbstractSocket* socket, QJsonObject const& message)
+QByteArray NetworkBase::frame(QByteArray const& payload)
 {
-    QDataStream ds(socket);
+    QByteArray framed;
+    framed.reserve(payload.size() + static_cast<int>(sizeof(quint32)));
+
+    QDataStream ds(&framed, QIODevice::WriteOnly);
     ds.setVersion(COMPRESSION_VERSION);
-    ds << QJsonDocument(message).toJson(QJsonDocument::Compact);
+    ds << payload;
+
+    return framed;
+}
+
+NetworkBase::WireFormat NetworkBase::formatOf(QByteArray const& payload)
+{
+    if (!payload.isEmpty() && payload[0] == BINARY_MAGIC)
+    {
+        return WireFormat::BINARY_FORMAT;
+    }
+
+    return WireFormat::JSON_FORMAT;
+}
+
+NetworkBase::WireFormat NetworkBase::wireFormat(QAbstractSocket* socket) const
+{
+    return _wireFormats.value(socket, WireFormat::JSON_FORMAT);
+}
+
+void NetworkBase::setWireFormat(QAbstractSocket* socket, WireFormat format)
+{
+    _wireFormats[socket] = format;
+}
+
+void NetworkBase::forgetSocket(QAbstractSocket* socket)
+{
+    _wireFormats.remove(socket);
+    _outboundQueues.remove(socket);
+    _datagramPeers.remove(socket);
+}
+
+bool NetworkBase::bindDatagramSocket(QHostAddress const& address, quint16 port)
+{
+    closeDatagramSocket();
+    return _datagramSocket->bind(address, port);
+}
+
+void NetworkBase::closeDatagramSocket()
+{
+    _datagramSocket->close();
+    _datagramPeers.clear();
+}
+
+quint16 NetworkBase::datagramPort() const
+{
+    if (_datagramSocket->state() != QAbstractSocket::BoundState)
+    {
+        return 0;
+    }
+
+    return _datagramSocket->localPort();
+}
+
+void NetworkBase::setDatagramPeer(QAbstractSocket* socket, QHostAddress const& address, quint16 port)
+{
+    DatagramPeer& peer = _datagramPeers[socket];
+    peer.address = address;
+    peer.port = port;
+}
+
+bool NetworkBase::isUnreliable(MessageType type)
+{
+    return type == MessageType::POSITION_UPDATE || type == MessageType::WORLD_SNAPSHOT || type == MessageType::SNAPSHOT_ACK;
+}
+
+void NetworkBase::onDatagramsReady()
+{
+    while (_datagramSocket->hasPendingDatagrams())
+    {
+        QByteArray datagram(static_cast<int>(_datagramSocket->pendingDatagramSize()), Qt::Uninitialized);
+        QHostAddress senderAddress;
+        quint16 senderPort = 0;
+
+        if (_datagramSocket->readDatagram(datagram.data(), datagram.size(), &senderAddress, &senderPort) < 0)
+        {
+            continue;
+        }
+
+        // Only accept datagrams from the endpoint a peer announced while joining
+        QAbstractSocket* socket = nullptr;
+        for (auto it = _datagramPeers.cbegin(); it != _datagramPeers.cend(); ++it)
+        {
+            if (it->port == senderPort && it->address.isEqual(senderAddress, QHostAddress::TolerantConversion))
+            {
+                socket = it.key();
+                break;
+            }
+        }
+
+        if (socket == nullptr)
+        {
+            continue;
+        }
+
+        BinaryReader reader(datagram);
+        quint32 sequence = reader.readUInt32();
+        if (!reader.ok())
+        {
+            continue;
+        }
+
+        // Each datagram carries the newest state as of its tick, so one that arrives
+        //  after a datagram of a later tick has nothing left to contribute. The datagrams
+        //  of one tick share its sequence number, and may arrive in any order.
+        DatagramPeer& peer = _datagramPeers[socket];
+        if (static_cast<qint32>(sequence - peer.receivedSequence) < 0)
+        {
+            _staleDatagrams++;
+            continue;
+        }
+        peer.receivedSequence = sequence;
+
+        receivedFrom(socket);
+
+        while (!reader.atEnd())
+        {
+            int length = reader.readUInt16();
+            QByteArray payload = reader.readBytes(length);
+            if (!reader.ok())
+            {
+                break;
+            }
+
+            Message message;
+            if (formatOf(payload) == WireFormat::BINARY_FORMAT && decode(payload, message) && isUnreliable(message.type))
+            {
+                _receivedPayload = payload;
+                dispatchMessage(socket, message);
+                _receivedPayload.clear();
+            }
+        }
+    }
 }
 
-QJsonObject const NetworkBase::joinRequest(PlayerColor color, QString const& username)
+NetworkBase::Message const NetworkBase::joinRequest(PlayerColor color, QString const& username, int protocolVersion, quint16 datagramPort)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::JOIN_REQUEST);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::USERNAME)] = username;
+    Message message;
+    message.type = MessageType::JOIN_REQUEST;
+    message.color = color;
+    message.username = username;
+    message.protocolVersion = protocolVersion;
+    message.datagramPort = datagramPort;
     return message;
 }
 
-QJsonObject const NetworkBase::joinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error)
+NetworkBase::Message const NetworkBase::joinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error, int protocolVersion, quint16 datagramPort)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::JOIN_RESPONSE);
-    message[toString(MessageParam::JOIN_SUCCEEDED)] = succeeded;
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::USERNAME)] = username;
-    message[toString(MessageParam::JOIN_ERROR)] = error;
+    Message message;
+    message.type = MessageType::JOIN_RESPONSE;
+    message.succeeded = succeeded;
+    message.color = color;
+    message.username = username;
+    message.error = error;
+    message.protocolVersion = protocolVersion;
+    message.datagramPort = datagramPort;
     return message;
 }
 
-QJsonObject const NetworkBase::positionMessage(PlayerColor color, QPointF position)
+NetworkBase::Message const NetworkBase::positionMessage(PlayerColor color, QPointF position, quint32 inputSequence)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::POSITION_UPDATE);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::POSITION_X)] = position.x();
-    message[toString(MessageParam::POSITION_Y)] = position.y();
+    Message message;
+    message.type = MessageType::POSITION_UPDATE;
+    message.color = color;
+    message.position = position;
+    message.inputSequence = inputSequence;
     return message;
 }
 
-QJsonObject const NetworkBase::bulletMessage(PlayerColor color, QPointF source, qreal angle)
+NetworkBase::Message const NetworkBase::bulletMessage(PlayerColor color, QPointF source, qreal angle)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::BULLET_SHOT);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::POSITION_X)] = source.x();
-    message[toString(MessageParam::POSITION_Y)] = source.y();
-    message[toString(MessageParam::BULLET_ANGLE)] = angle;
+    Message message;
+    message.type = MessageType::BULLET_SHOT;
+    message.color = color;
+    message.position = source;
+    message.angle = angle;
     return message;
 }
 
-QJsonObject const NetworkBase::healthMessage(PlayerColor color, int health, bool hasCrown)
+NetworkBase::Message const NetworkBase::healthMessage(PlayerColor color, int health, bool hasCrown)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::HEALTH_UPDATE);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::HEALTH)] = health;
-    message[toString(MessageParam::CROWN)] = hasCrown;
+    Message message;
+    message.type = MessageType::HEALTH_UPDATE;
+    message.color = color;
+    message.health = health;
+    message.hasCrown = hasCrown;
     return message;
 }
 
-QJsonObject const NetworkBase::gameStartMessage(int gameTime)
+NetworkBase::Message const NetworkBase::gameStartMessage(int gameTime)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::GAME_START);
-    message[toString(MessageParam::GAME_TIME)] = gameTime;
+    Message message;
+    message.type = MessageType::GAME_START;
+    message.gameTime = gameTime;
     return message;
 }
 
-QJsonObject const NetworkBase::gameEndMessage(PlayerColor winner, QString const& username)
+NetworkBase::Message const NetworkBase::gameEndMessage(PlayerColor winner, QString const& username)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::GAME_END);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(winner);
-    message[toString(MessageParam::USERNAME)] = username;
+    Message message;
+    message.type = MessageType::GAME_END;
+    message.color = winner;
+    message.username = username;
     return message;
 }
 
-QJsonObject const NetworkBase::playerJoinedMessage(PlayerColor color, QString const& username)
+NetworkBase::Message const NetworkBase::playerJoinedMessage(PlayerColor color, QString const& username)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::PLAYER_JOINED);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::USERNAME)] = username;
+    Message message;
+    message.type = MessageType::PLAYER_JOINED;
+    message.color = color;
+    message.username = username;
     return message;
 }
 
-QJsonObject const NetworkBase::playerLeftMessage(PlayerColor color, QString const& username)
+NetworkBase::Message const NetworkBase::playerLeftMessage(PlayerColor color, QString const& username)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::PLAYER_LEFT);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::USERNAME)] = username;
+    Message message;
+    message.type = MessageType::PLAYER_LEFT;
+    message.color = color;
+    message.username = username;
     return message;
 }
 
-QJsonObject const NetworkBase::chatMessage(PlayerColor color, QString const& username, QString const& body)
+NetworkBase::Message const NetworkBase::chatMessage(PlayerColor color, QString const& username, QString const& body)
 {
-    QJsonObject message;
-    message[toString(MessageParam::MESSAGE_TYPE)] = toString(MessageType::CHAT_MESSAGE);
-    message[toString(MessageParam::COLOR)] = static_cast<int>(color);
-    message[toString(MessageParam::USERNAME)] = username;
-    message[toString(MessageParam::CHAT_BODY)] = body;
+    Message message;
+    message.type = MessageType::CHAT_MESSAGE;
+    message.color = color;
+    message.username = username;
+    message.body = body;
     return message;
 }
 
-bool NetworkBase::parseJoinRequest(QAbstractSocket* socket, QJsonObject const& message)
+NetworkBase::Message const NetworkBase::snapshotMessage(WorldSnapshot const& snapshot, WorldSnapshot const& baseline)
+{
+    Message message;
+    message.type = MessageType::WORLD_SNAPSHOT;
+    message.snapshot = snapshot;
+    message.baseline = baseline;
+    return message;
+}
+
+NetworkBase::Message const NetworkBase::snapshotAckMessage(quint32 tick)
+{
+    Message message;
+    message.type = MessageType::SNAPSHOT_ACK;
+    message.tick = tick;
+    return message;
+}
+
+NetworkBase::Message const NetworkBase::mapDataMessage(MapData const& map)
+{
+    Message message;
+    message.type = MessageType::MAP_DATA;
+    message.map = map;
+    return message;
+}
+
+QByteArray NetworkBase::encode(Message const& message, WireFormat format)
+{
+    switch (format)
+    {
+    case WireFormat::BINARY_FORMAT:
+        return encodeBinary(message);
+    case WireFormat::JSON_FORMAT:
+        break;
+    }
+
+    return encodeJson(message);
+}
+
+bool NetworkBase::decode(QByteArray const& payload, Message& message)
 {
-    QJsonValue colorValue = message.value(toString(MessageParam::COLOR));
+    if (formatOf(payload) == WireFormat::BINARY_FORMAT)
+    {
+        return decodeBinary(payload, message);
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(payload, &parseError);
+
+    if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject())
+    {
+        return false;
+    }
+
+    return parseMessage(jsonDoc.object(), message);
+}
+
+QByteArray NetworkBase::encodeJson(Message const& message)
+{
+    QJsonObject json;
+    json[toString(MessageParam::MESSAGE_TYPE)] = toString(message.type);
+
+    switch (message.type)
+    {
+    case MessageType::JOIN_REQUEST:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::USERNAME)] = message.username;
+        if (message.protocolVersion > 0)
+        {
+            json[toString(MessageParam::PROTOCOL_VERSION)] = message.protocolVersion;
+        }
+        if (message.datagramPort > 0)
+        {
+            json[toString(MessageParam::DATAGRAM_PORT)] = message.datagramPort;
+        }
+        break;
+    case MessageType::JOIN_RESPONSE:
+        json[toString(MessageParam::JOIN_SUCCEEDED)] = message.succeeded;
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::USERNAME)] = message.username;
+        json[toString(MessageParam::JOIN_ERROR)] = message.error;
+        if (message.protocolVersion > 0)
+        {
+            json[toString(MessageParam::PROTOCOL_VERSION)] = message.protocolVersion;
+        }
+        if (message.datagramPort > 0)
+        {
+            json[toString(MessageParam::DATAGRAM_PORT)] = message.datagramPort;
+        }
+        break;
+    case MessageType::POSITION_UPDATE:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::POSITION_X)] = message.position.x();
+        json[toString(MessageParam::POSITION_Y)] = message.position.y();
+        if (message.inputSequence > 0)
+        {
+            json[toString(MessageParam::INPUT_SEQUENCE)] = static_cast<qint64>(message.inputSequence);
+        }
+        break;
+    case MessageType::BULLET_SHOT:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::POSITION_X)] = message.position.x();
+        json[toString(MessageParam::POSITION_Y)] = message.position.y();
+        json[toString(MessageParam::BULLET_ANGLE)] = message.angle;
+        break;
+    case MessageType::HEALTH_UPDATE:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::HEALTH)] = message.health;
+        json[toString(MessageParam::CROWN)] = message.hasCrown;
+        break;
+    case MessageType::GAME_START:
+        json[toString(MessageParam::GAME_TIME)] = message.gameTime;
+        break;
+    case MessageType::GAME_END:
+    case MessageType::PLAYER_JOINED:
+    case MessageType::PLAYER_LEFT:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::USERNAME)] = message.username;
+        break;
+    case MessageType::CHAT_MESSAGE:
+        json[toString(MessageParam::COLOR)] = static_cast<int>(message.color);
+        json[toString(MessageParam::USERNAME)] = message.username;
+        json[toString(MessageParam::CHAT_BODY)] = message.body;
+        break;
+    case MessageType::WORLD_SNAPSHOT:
+    case MessageType::SNAPSHOT_ACK:
+    case MessageType::MAP_DATA:
+        // Snapshots and maps are only ever exchanged with clients that negotiated the binary protocol
+        break;
+    }
+
+    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+}
+
+QByteArray NetworkBase::encodeBinary(Message const& message)
+{
+    // Every binary payload starts with the same 3 byte header:
+    //  [magic][protocol version][message type]
+    QByteArray data;
+    data.reserve(32);
+
+    BinaryWriter writer(data);
+    writer.writeUInt8(static_cast<quint8>(BINARY_MAGIC));
+    writer.writeUInt8(BINARY_PROTOCOL_VERSION);
+    writer.writeUInt8(static_cast<quint8>(message.type));
+
+    switch (message.type)
+    {
+    case MessageType::JOIN_REQUEST:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeUInt8(static_cast<quint8>(message.protocolVersion));
+        writer.writeUInt16(message.datagramPort);
+        writer.writeString(message.username);
+        break;
+    case MessageType::JOIN_RESPONSE:
+        writer.writeUInt8(message.succeeded ? 1 : 0);
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeUInt8(static_cast<quint8>(message.error));
+        writer.writeUInt8(static_cast<quint8>(message.protocolVersion));
+        writer.writeUInt16(message.datagramPort);
+        writer.writeString(message.username);
+        break;
+    case MessageType::POSITION_UPDATE:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeFloat(message.position.x());
+        writer.writeFloat(message.position.y());
+        writer.writeUInt32(message.inputSequence);
+        break;
+    case MessageType::BULLET_SHOT:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeFloat(message.position.x());
+        writer.writeFloat(message.position.y());
+        writer.writeFloat(message.angle);
+        break;
+    case MessageType::HEALTH_UPDATE:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeInt16(static_cast<qint16>(message.health));
+        writer.writeUInt8(message.hasCrown ? 1 : 0);
+        break;
+    case MessageType::GAME_START:
+        writer.writeInt32(message.gameTime);
+        break;
+    case MessageType::GAME_END:
+    case MessageType::PLAYER_JOINED:
+    case MessageType::PLAYER_LEFT:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeString(message.username);
+        break;
+    case MessageType::CHAT_MESSAGE:
+        writer.writeUInt8(static_cast<quint8>(message.color));
+        writer.writeString(message.username);
+        writer.writeString(message.body);
+        break;
+    case MessageType::WORLD_SNAPSHOT:
+        writer.writeUInt32(message.baseline.tick);
+        if (message.baseline.tick == 0)
+        {
+            message.snapshot.write(writer);
+        }
+        else
+        {
+            message.snapshot.writeDelta(writer, message.baseline);
+        }
+        break;
+    case MessageType::SNAPSHOT_ACK:
+        writer.writeUInt32(message.tick);
+        break;
+    case MessageType::MAP_DATA:
+        message.map.write(writer);
+        break;
+    }
+
+    return data;
+}
+
+bool NetworkBase::decodeBinary(QByteArray const& payload, Message& message)
+{
+    BinaryReader reader(payload);
+
+    reader.readUInt8(); // magic
+    quint8 version = reader.readUInt8();
+    quint8 type = reader.readUInt8();
+
+    if (!reader.ok() || version != BINARY_PROTOCOL_VERSION || type > MessageType::MAP_DATA)
+    {
+        return false;
+    }
+
+    message = Message();
+    message.type = static_cast<MessageType>(type);
+
+    switch (message.type)
+    {
+    case MessageType::JOIN_REQUEST:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.protocolVersion = reader.readUInt8();
+        message.datagramPort = reader.readUInt16();
+        message.username = reader.readString();
+        break;
+    case MessageType::JOIN_RESPONSE:
+        message.succeeded = reader.readUInt8() != 0;
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.error = static_cast<JoinError>(reader.readUInt8());
+        message.protocolVersion = reader.readUInt8();
+        message.datagramPort = reader.readUInt16();
+        message.username = reader.readString();
+        break;
+    case MessageType::POSITION_UPDATE:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.position.setX(reader.readFloat());
+        message.position.setY(reader.readFloat());
+        message.inputSequence = reader.readUInt32();
+        break;
+    case MessageType::BULLET_SHOT:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.position.setX(reader.readFloat());
+        message.position.setY(reader.readFloat());
+        message.angle = reader.readFloat();
+        break;
+    case MessageType::HEALTH_UPDATE:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.health = reader.readInt16();
+        message.hasCrown = reader.readUInt8() != 0;
+        break;
+    case MessageType::GAME_START:
+        message.gameTime = reader.readInt32();
+        break;
+    case MessageType::GAME_END:
+    case MessageType::PLAYER_JOINED:
+    case MessageType::PLAYER_LEFT:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.username = reader.readString();
+        break;
+    case MessageType::CHAT_MESSAGE:
+        message.color = static_cast<PlayerColor>(reader.readUInt8());
+        message.username = reader.readString();
+        message.body = reader.readString();
+        break;
+    case MessageType::WORLD_SNAPSHOT:
+        message.baseline.tick = reader.readUInt32();
+        if (message.baseline.tick == 0)
+        {
+            message.snapshot.read(reader);
+        }
+        else if (reader.ok())
+        {
+            // Decoding a delta requires its baseline, which is looked up when dispatching
+            message.snapshotDelta = payload.mid(reader.offset());
+        }
+        break;
+    case MessageType::SNAPSHOT_ACK:
+        message.tick = reader.readUInt32();
+        break;
+    case MessageType::MAP_DATA:
+        message.map.read(reader);
+        break;
+    }
+
+    return reader.ok();
+}
+
+bool NetworkBase::parseJoinRequest(QJsonObject const& json, Message& message)
+{
+    QJsonValue colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue usernameValue = message.value(toString(MessageParam::USERNAME));
+    QJsonValue usernameValue = json.value(toString(MessageParam::USERNAME));
     if (usernameValue.isNull() || !usernameValue.isString())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    QString const& username = usernameValue.toString();
+    // Clients that predate the binary protocol do not send a protocol version
+    QJsonValue protocolValue = json.value(toString(MessageParam::PROTOCOL_VERSION));
 
-    onParsedJoinRequest(socket, color, username);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.username = usernameValue.toString();
+    message.protocolVersion = protocolValue.toInt(0);
+    message.datagramPort = static_cast<quint16>(json.value(toString(MessageParam::DATAGRAM_PORT)).toInt(0));
     return true;
 }
 
-bool NetworkBase::parseJoinResponse(QJsonObject const& message)
+bool NetworkBase::parseJoinResponse(QJsonObject const& json, Message& message)
 {
-    QJsonValue succeededValue = message.value(toString(MessageParam::JOIN_SUCCEEDED));
+    QJsonValue succeededValue = json.value(toString(MessageParam::JOIN_SUCCEEDED));
     if (succeededValue.isNull() || !succeededValue.isBool())
     {
         return false;
     }
 
-    QJsonValue colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue usernameValue = message.value(toString(MessageParam::USERNAME));
+    QJsonValue usernameValue = json.value(toString(MessageParam::USERNAME));
     if (usernameValue.isNull() || !usernameValue.isString())
     {
         return false;
     }
 
-    QJsonValue errorValue = message.value(toString(MessageParam::JOIN_ERROR));
+    QJsonValue errorValue = json.value(toString(MessageParam::JOIN_ERROR));
     if (errorValue.isNull())
     {
         return false;
     }
 
-    bool succeeded = succeededValue.toBool();
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    QString const& username = usernameValue.toString();
-    JoinError error = static_cast<JoinError>(errorValue.toInt());
+    // Hosts that predate the binary protocol do not send a protocol version
+    QJsonValue protocolValue = json.value(toString(MessageParam::PROTOCOL_VERSION));
 
-    onParsedJoinResponse(succeeded, color, username, error);
+    message.succeeded = succeededValue.toBool();
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.username = usernameValue.toString();
+    message.error = static_cast<JoinError>(errorValue.toInt());
+    message.protocolVersion = protocolValue.toInt(0);
+    message.datagramPort = static_cast<quint16>(json.value(toString(MessageParam::DATAGRAM_PORT)).toInt(0));
     return true;
 }
 
-bool NetworkBase::parsePositionMessage(QJsonObject const& message)
+bool NetworkBase::parsePositionMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue xValue = message.value(toString(MessageParam::POSITION_X));
+    QJsonValue xValue = json.value(toString(MessageParam::POSITION_X));
     if (xValue.isNull() || !xValue.isDouble())
     {
         return false;
     }
 
-    QJsonValue yValue = message.value(toString(MessageParam::POSITION_Y));
+    QJsonValue yValue = json.value(toString(MessageParam::POSITION_Y));
     if (yValue.isNull() || !yValue.isDouble())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    qreal x = xValue.toDouble();
-    qreal y = yValue.toDouble();
-    QPointF position(x, y);
+    // Clients that predate prediction do not number their inputs
+    QJsonValue sequenceValue = json.value(toString(MessageParam::INPUT_SEQUENCE));
 
-    onParsedPositionMessage(color, position);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.position = QPointF(xValue.toDouble(), yValue.toDouble());
+    message.inputSequence = static_cast<quint32>(sequenceValue.toDouble(0));
     return true;
 }
 
-bool NetworkBase::parseHealthMessage(QJsonObject const& message)
+bool NetworkBase::parseHealthMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue healthValue = message.value(toString(MessageParam::HEALTH));
+    QJsonValue healthValue = json.value(toString(MessageParam::HEALTH));
     if (healthValue.isNull())
     {
         return false;
     }
 
-    QJsonValue hasCrownValue = message.value(toString(MessageParam::CROWN));
+    QJsonValue hasCrownValue = json.value(toString(MessageParam::CROWN));
     if (hasCrownValue.isNull() || !hasCrownValue.isBool())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    int health = healthValue.toInt();
-    bool hasCrown = hasCrownValue.toBool();
-
-    onParsedHealthMessage(color, health, hasCrown);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.health = healthValue.toInt();
+    message.hasCrown = hasCrownValue.toBool();
     return true;
 }
 
-bool NetworkBase::parseBulletMessage(QJsonObject const& message)
+bool NetworkBase::parseBulletMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue sourceXValue = message.value(toString(MessageParam::POSITION_X));
+    QJsonValue sourceXValue = json.value(toString(MessageParam::POSITION_X));
     if (sourceXValue.isNull() || !sourceXValue.isDouble())
     {
         return false;
     }
 
-    QJsonValue sourceYValue = message.value(toString(MessageParam::POSITION_Y));
+    QJsonValue sourceYValue = json.value(toString(MessageParam::POSITION_Y));
     if (sourceYValue.isNull() || !sourceYValue.isDouble())
     {
         return false;
     }
 
-    QJsonValue angleValue = message.value(toString(MessageParam::BULLET_ANGLE));
+    QJsonValue angleValue = json.value(toString(MessageParam::BULLET_ANGLE));
     if (angleValue.isNull() || !angleValue.isDouble())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    qreal sourceX = sourceXValue.toDouble();
-    qreal sourceY = sourceYValue.toDouble();
-    qreal angle = angleValue.toDouble();
-    QPointF source(sourceX, sourceY);
-
-    onParsedBulletMessage(color, source, angle);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.position = QPointF(sourceXValue.toDouble(), sourceYValue.toDouble());
+    message.angle = angleValue.toDouble();
     return true;
 }
 
-bool NetworkBase::parseGameStartMessage(QJsonObject const& message)
+bool NetworkBase::parseGameStartMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue gameTimeValue = message.value(toString(MessageParam::GAME_TIME));
+    QJsonValue gameTimeValue = json.value(toString(MessageParam::GAME_TIME));
     if (gameTimeValue.isNull())
     {
         return false;
     }
 
-    int gameTime = gameTimeValue.toInt();
-
-    onParsedGameStartMessage(gameTime);
-    return true;
-}
-
-bool NetworkBase::parseGameEndMessage(QJsonObject const& message)
-{
-    QJsonValue winnerValue = message.value(toString(MessageParam::COLOR));
-    if (winnerValue.isNull())
-    {
-        return false;
-    }
-
-    QJsonValue const usernameValue = message.value(toString(MessageParam::USERNAME));
-    if (usernameValue.isNull() || !usernameValue.isString())
-    {
-        return false;
-    }
-
-    PlayerColor winner = static_cast<PlayerColor>(winnerValue.toInt());
-    QString const& username = usernameValue.toString();
-
-    onParsedGameEndMessage(winner, username);
-    return true;
-}
-
-bool NetworkBase::parsePlayerJoinedMessage(QJsonObject const& message)
-{
-    QJsonValue const colorValue = message.value(toString(MessageParam::COLOR));
-    if (colorValue.isNull())
-    {
-        return false;
-    }
-
-    QJsonValue const usernameValue = message.value(toString(MessageParam::USERNAME));
-    if (usernameValue.isNull() || !usernameValue.isString())
-    {
-        return false;
-    }
-
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    QString const& username = usernameValue.toString();
-
-    onParsedPlayerJoinedMessage(color, username);
+    message.gameTime = gameTimeValue.toInt();
     return true;
 }
 
-bool NetworkBase::parsePlayerLeftMessage(QJsonObject const& message)
+bool NetworkBase::parsePlayerMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue const colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue const colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue const usernameValue = message.value(toString(MessageParam::USERNAME));
+    QJsonValue const usernameValue = json.value(toString(MessageParam::USERNAME));
     if (usernameValue.isNull() || !usernameValue.isString())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    QString const& username = usernameValue.toString();
-
-    onParsedPlayerLeftMessage(color, username);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.username = usernameValue.toString();
     return true;
 }
 
-bool NetworkBase::parseChatMessage(QJsonObject const& message)
+bool NetworkBase::parseChatMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue const colorValue = message.value(toString(MessageParam::COLOR));
+    QJsonValue const colorValue = json.value(toString(MessageParam::COLOR));
     if (colorValue.isNull())
     {
         return false;
     }
 
-    QJsonValue const usernameValue = message.value(toString(MessageParam::USERNAME));
+    QJsonValue const usernameValue = json.value(toString(MessageParam::USERNAME));
     if (usernameValue.isNull() || !usernameValue.isString())
     {
         return false;
     }
 
-    QJsonValue const bodyValue = message.value(toString(MessageParam::CHAT_BODY));
+    QJsonValue const bodyValue = json.value(toString(MessageParam::CHAT_BODY));
     if (bodyValue.isNull() || !bodyValue.isString())
     {
         return false;
     }
 
-    PlayerColor color = static_cast<PlayerColor>(colorValue.toInt());
-    QString const& username = usernameValue.toString();
-    QString body = bodyValue.toString();
-
-    onParsedChatMessage(color, username, body);
+    message.color = static_cast<PlayerColor>(colorValue.toInt());
+    message.username = usernameValue.toString();
+    message.body = bodyValue.toString();
     return true;
 }
 
-bool NetworkBase::parseMessage(QAbstractSocket* socket, QJsonObject const& message)
+bool NetworkBase::parseMessage(QJsonObject const& json, Message& message)
 {
-    QJsonValue typeValue = message.value(toString(MessageParam::MESSAGE_TYPE));
+    QJsonValue typeValue = json.value(toString(MessageParam::MESSAGE_TYPE));
     if (typeValue.isNull())
     {
         return false;
@@ -374,39 +910,108 @@ bool NetworkBase::parseMessage(QAbstractSocket* socket, QJsonObject const& messa
     MessageType type;
     if (tryParse(typeValue.toString(), type))
     {
+        message = Message();
+        message.type = type;
+
         switch (type)
         {
         case MessageType::JOIN_REQUEST:
-            return parseJoinRequest(socket, message);
+            return parseJoinRequest(json, message);
         case MessageType::JOIN_RESPONSE:
-            return parseJoinResponse(message);
+            return parseJoinResponse(json, message);
         case MessageType::POSITION_UPDATE:
-            return parsePositionMessage(message);
+            return parsePositionMessage(json, message);
         case MessageType::BULLET_SHOT:
-            return parseBulletMessage(message);
+            return parseBulletMessage(json, message);
         case MessageType::HEALTH_UPDATE:
-            return parseHealthMessage(message);
+            return parseHealthMessage(json, message);
         case MessageType::GAME_START:
-            return parseGameStartMessage(message);
+            return parseGameStartMessage(json, message);
         case MessageType::GAME_END:
-            return parseGameEndMessage(message);
         case MessageType::PLAYER_JOINED:
-            return parsePlayerJoinedMessage(message);
         case MessageType::PLAYER_LEFT:
-            return parsePlayerLeftMessage(message);
+            return parsePlayerMessage(json, message);
         case MessageType::CHAT_MESSAGE:
-            return parseChatMessage(message);
+            return parseChatMessage(json, message);
+        case MessageType::WORLD_SNAPSHOT:
+        case MessageType::SNAPSHOT_ACK:
+        case MessageType::MAP_DATA:
+            return false;
         }
     }
 
     return false;
 }
 
+void NetworkBase::dispatchMessage(QAbstractSocket* socket, Message const& message)
+{
+    _receivedSocket = socket;
+
+    switch (message.type)
+    {
+    case MessageType::JOIN_REQUEST:
+        onParsedJoinRequest(socket, message.color, message.username, message.protocolVersion, message.datagramPort);
+        break;
+    case MessageType::JOIN_RESPONSE:
+        onParsedJoinResponse(message.succeeded, message.color, message.username, message.error, message.protocolVersion, message.datagramPort);
+        break;
+    case MessageType::POSITION_UPDATE:
+        onParsedPositionMessage(message.color, message.position, message.inputSequence);
+        break;
+    case MessageType::BULLET_SHOT:
+        onParsedBulletMessage(message.color, message.position, message.angle);
+        break;
+    case MessageType::HEALTH_UPDATE:
+        onParsedHealthMessage(message.color, message.health, message.hasCrown);
+        break;
+    case MessageType::GAME_START:
+        onParsedGameStartMessage(message.gameTime);
+        break;
+    case MessageType::GAME_END:
+        onParsedGameEndMessage(message.color, message.username);
+        break;
+    case MessageType::PLAYER_JOINED:
+        onParsedPlayerJoinedMessage(message.color, message.username);
+        break;
+    case MessageType::PLAYER_LEFT:
+        onParsedPlayerLeftMessage(message.color, message.username);
+        break;
+    case MessageType::CHAT_MESSAGE:
+        onParsedChatMessage(message.color, message.username, message.body);
+        break;
+    case MessageType::WORLD_SNAPSHOT:
+        if (message.baseline.tick == 0)
+        {
+            onParsedSnapshotMessage(message.snapshot);
+        }
+        else if (WorldSnapshot const* baseline = snapshotBaseline(message.baseline.tick))
+        {
+            WorldSnapshot snapshot;
+            BinaryReader reader(message.snapshotDelta);
+
+            if (snapshot.readDelta(reader, *baseline))
+            {
+                onParsedSnapshotMessage(snapshot);
+            }
+        }
+        break;
+    case MessageType::SNAPSHOT_ACK:
+        onParsedSnapshotAck(socket, message.tick);
+        break;
+    case MessageType::MAP_DATA:
+        onParsedMapData(message.map);
+        break;
+    }
+
+    _receivedSocket = nullptr;
+}
+
 void NetworkBase::onReadyRead(QAbstractSocket* socket)
 {
     receivedFrom(socket);
 
-    QByteArray jsonData;
+    QByteArray payload;
+    Message message;
 
     QDataStream in(socket);
     in.setVersion(COMPRESSION_VERSION);
@@ -417,16 +1022,16 @@ void NetworkBase::onReadyRead(QAbstractSocket* socket)
         //  not yet been received
 
         in.startTransaction();
-        in >> jsonData;
+        in >> payload;
 
         if (in.commitTransaction())
         {
-            QJsonParseError parseError;
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
-
-            if (parseError.error == QJsonParseError::NoError && jsonDoc.isObject())
+            if (decode(payload, message))
             {
-                parseMessage(socket, jsonDoc.object());
+                // Keep the raw payload around so that it can be forwarded without re-encoding
+                _receivedPayload = payload;
+                dispatchMessage(socket, message);
+                _receivedPayload.clear();
             }
         }
         else
@@ -460,6 +1065,12 @@ QString NetworkBase::toString(MessageType messageType)
         return QStringLiteral("player_left");
     case MessageType::CHAT_MESSAGE:
         return QStringLiteral("chat_message");
+    case MessageType::WORLD_SNAPSHOT:
+        return QStringLiteral("world_snapshot");
+    case MessageType::SNAPSHOT_ACK:
+        return QStringLiteral("snapshot_ack");
+    case MessageType::MAP_DATA:
+        return QStringLiteral("map_data");
     }
 
     return QStringLiteral("INVALID");
@@ -493,6 +1104,12 @@ QString NetworkBase::toString(MessageParam messageParam)
         return QStringLiteral("join_error");
     case MessageParam::CHAT_BODY:
         return QStringLiteral("chat_body");
+    case MessageParam::PROTOCOL_VERSION:
+        return QStringLiteral("protocol_version");
+    case MessageParam::DATAGRAM_PORT:
+        return QStringLiteral("datagram_port");
+    case MessageParam::INPUT_SEQUENCE:
+        return QStringLiteral("input_sequence");
     }
 
     return QStringLiteral("INVALID");
@@ -602,6 +1219,9 @@ bool NetworkBase::tryParse(QString const& string, MessageType& result)
          { QStringLiteral("player_joined"), MessageType::PLAYER_JOINED },
          { QStringLiteral("player_left"), MessageType::PLAYER_LEFT },
          { QStringLiteral("chat_message"), MessageType::CHAT_MESSAGE },
+         { QStringLiteral("world_snapshot"), MessageType::WORLD_SNAPSHOT },
+         { QStringLiteral("snapshot_ack"), MessageType::SNAPSHOT_ACK },
+         { QStringLiteral("map_data"), MessageType::MAP_DATA },
          };
 
     if (messageTypes.contains(string))
@@ -629,6 +1249,9 @@ bool NetworkBase::tryParse(QString const& string, MessageParam& result)
          { QStringLiteral("join_succeeded"), MessageParam::JOIN_SUCCEEDED },
          { QStringLiteral("join_error"), MessageParam::JOIN_ERROR },
          { QStringLiteral("chat_body"), MessageParam::CHAT_BODY },
+         { QStringLiteral("protocol_version"), MessageParam::PROTOCOL_VERSION },
+         { QStringLiteral("datagram_port"), MessageParam::DATAGRAM_PORT },
+         { QStringLiteral("input_sequence"), MessageParam::INPUT_SEQUENCE },
          };
 
     if (messageParams.contains(string))
@@ -642,9 +1265,9 @@ bool NetworkBase::tryParse(QString const& string, MessageParam& result)
 
 // These methods are left empty so that any number of them may be overridden by a base
 //  class host or client, but none have to be overridden (as they would if they were pure virtual).
-void NetworkBase::onParsedJoinRequest(QAbstractSocket*, PlayerColor, QString const&) { }
-void NetworkBase::onParsedJoinResponse(bool, PlayerColor, QString const&, JoinError) { }
-void NetworkBase::onParsedPositionMessage(PlayerColor, QPointF) { }
+void NetworkBase::onParsedJoinRequest(QAbstractSocket*, PlayerColor, QString const&, int, quint16) { }
+void NetworkBase::onParsedJoinResponse(bool, PlayerColor, QString const&, JoinError, int, quint16) { }
+void NetworkBase::onParsedPositionMessage(PlayerColor, QPointF, quint32) { }
 void NetworkBase::onParsedBulletMessage(PlayerColor, QPointF, qreal) { }
 void NetworkBase::onParsedHealthMessage(PlayerColor, int, bool) { }
 void NetworkBase::onParsedGameStartMessage(int) { }
@@ -652,3 +1275,7 @@ void NetworkBase::onParsedGameEndMessage(PlayerColor, QString const&) { }
 void NetworkBase::onParsedPlayerJoinedMessage(PlayerColor, QString const&) { }
 void NetworkBase::onParsedPlayerLeftMessage(PlayerColor, QString const&) { }
 void NetworkBase::onParsedChatMessage(PlayerColor, QString const&, QString const&) { }
+void NetworkBase::onParsedSnapshotMessage(WorldSnapshot const&) { }
+void NetworkBase::onParsedSnapshotAck(QAbstractSocket*, quint32) { }
+void NetworkBase::onParsedMapData(MapData const&) { }
+WorldSnapshot const* NetworkBase::snapshotBaseline(quint32) const { return nullptr; }
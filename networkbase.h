@@ -1,18 +1,27 @@
 #ifndef NETWORKBASE_H
 #define NETWORKBASE_H
 
+#include "mapdata.h"
 #include "playercolor.h"
 #include "settings.h"
+#include "worldsnapshot.h"
 
 #include <QAbstractSocket>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QHostAddress>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QObject>
+#include <QPointF>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
 
 /*!
  * \brief NetworkBase is an abstract class that provides common functionality for hosts and clients
- * to transmit and receive messages via TCP.
+ * to transmit and receive messages via TCP. Once both sides have negotiated the binary protocol,
+ * real-time messages whose newest value supersedes older ones may instead travel over UDP.
  * \author Scott
  */
 class NetworkBase : public QObject
@@ -35,6 +44,9 @@ public:
         PLAYER_JOINED,
         PLAYER_LEFT,
         CHAT_MESSAGE,
+        WORLD_SNAPSHOT,
+        SNAPSHOT_ACK,
+        MAP_DATA,
     };
 
     /*!
@@ -55,6 +67,20 @@ public:
         JOIN_SUCCEEDED,
         JOIN_ERROR,
         CHAT_BODY,
+        PROTOCOL_VERSION,
+        DATAGRAM_PORT,
+        INPUT_SEQUENCE,
+    };
+
+    /*!
+     * \brief The WireFormat enum specifies how messages are encoded on a socket.
+     * Every socket starts out using JSON until a binary protocol version has been
+     * negotiated while joining.
+     */
+    enum WireFormat
+    {
+        JSON_FORMAT,
+        BINARY_FORMAT,
     };
 
     /*!
@@ -93,6 +119,69 @@ public:
      */
     static QString toString(JoinError joinError);
 
+    /*!
+     * \brief The Message struct holds the contents of a message of any type,
+     * independent of the wire format it is sent or received in. Only the
+     * fields relevant to the message's type are meaningful.
+     */
+    struct Message
+    {
+        MessageType type = MessageType::JOIN_REQUEST;
+        PlayerColor color = PlayerColor::Red;
+        QString username;
+        QPointF position;
+        qreal angle = 0.0;
+        int health = 0;
+        bool hasCrown = false;
+        int gameTime = 0;
+        bool succeeded = false;
+        JoinError error = JoinError::NO_ERROR;
+        QString body;
+        int protocolVersion = 0;
+        quint16 datagramPort = 0;
+        quint32 inputSequence = 0;
+        WorldSnapshot snapshot;
+
+        /*!
+         * \brief The snapshot that a world snapshot message is delta-encoded against.
+         * A baseline tick of 0 means the message carries a full snapshot.
+         */
+        WorldSnapshot baseline;
+
+        /*!
+         * \brief The still encoded body of a received delta snapshot, which can only be
+         * decoded once its baseline has been looked up.
+         */
+        QByteArray snapshotDelta;
+
+        /*!
+         * \brief The server tick that a snapshot acknowledgement message refers to.
+         */
+        quint32 tick = 0;
+
+        /*!
+         * \brief The map that a map data message carries.
+         */
+        MapData map;
+    };
+
+    /*!
+     * \brief Encodes a message into the payload of a single frame.
+     * \param message the message to encode
+     * \param format the wire format to encode the message in
+     * \return the encoded payload
+     */
+    static QByteArray encode(Message const& message, WireFormat format);
+
+    /*!
+     * \brief Tries to decode the payload of a single frame into a message. The wire format
+     * is detected from the payload itself, so either format may be decoded on any socket.
+     * \param payload the payload of the received frame
+     * \param message the resulting message, if decoding was successful
+     * \return whether or not the payload was able to be decoded into a message
+     */
+    static bool decode(QByteArray const& payload, Message& message);
+
 signals:
 
     /*!
@@ -127,7 +216,7 @@ signals:
 
     /*!
      * \brief This signal is emitted by the host when the game has ended.
-     * \param winner the color of the player who won the game
+     * \param winner the color of the player who won the game, or NO_PLAYER if nobody did
      * \param username the username of the player who won the game
      */
     void gameEnded(PlayerColor winner, QString const& username);
@@ -154,6 +243,18 @@ signals:
      */
     void receivedChatMessage(PlayerColor color, QString const& username, QString const& body);
 
+    /*!
+     * \brief This signal is emitted when a world snapshot has been received from the host.
+     * \param snapshot the state of the world at the snapshot's server tick
+     */
+    void snapshotReceived(WorldSnapshot const& snapshot);
+
+    /*!
+     * \brief This signal is emitted when the host has sent the map of the game.
+     * \param map the map being played
+     */
+    void mapReceived(MapData const& map);
+
 protected:
     /*!
      * \brief Creates a new instance of the NetworkBase class.
@@ -162,19 +263,175 @@ protected:
     explicit NetworkBase(QObject* parent = nullptr);
 
     /*!
-     * \brief Sends the provided message via the specified socket.
+     * \brief Sends the provided message via the specified socket, encoded in the
+     * wire format that has been negotiated for that socket.
      * \param socket the socket via which to send the message
      * \param message the message to send
      */
-    static void sendMessage(QAbstractSocket* socket, QJsonObject const& message);
+    void sendMessage(QAbstractSocket* socket, Message const& message);
+
+    /*!
+     * \brief Queues an already framed message to be sent via the specified socket at the end
+     * of the current network tick. A queued position update supersedes any position update
+     * for the same player that is still waiting in the socket's queue.
+     * \param socket the socket via which to send the frame
+     * \param type the type of the framed message
+     * \param color the color of the player the framed message concerns
+     * \param framed the framed message to send
+     */
+    void queueFrame(QAbstractSocket* socket, MessageType type, PlayerColor color, QByteArray const& framed);
+
+    /*!
+     * \brief Immediately writes every queued frame for the specified socket as a single batch.
+     * \param socket the socket whose queue to flush
+     */
+    void flushOutbound(QAbstractSocket* socket);
+
+    /*!
+     * \brief Opens the UDP socket on which unreliable messages are sent and received.
+     * \param address the address to bind to
+     * \param port the port to bind to, or 0 to let the system choose one
+     * \return whether or not the socket was able to be bound
+     */
+    bool bindDatagramSocket(QHostAddress const& address = QHostAddress::Any, quint16 port = 0);
+
+    /*!
+     * \brief Closes the UDP socket, after which every message is sent via TCP again.
+     */
+    void closeDatagramSocket();
+
+    /*!
+     * \brief Returns the local port of the UDP socket.
+     * \return the port the UDP socket is bound to, or 0 if it is not bound
+     */
+    quint16 datagramPort() const;
+
+    /*!
+     * \brief Sends unreliable messages for the specified socket to a UDP endpoint instead of
+     * via TCP, and accepts unreliable messages from that endpoint as if they had been received
+     * on the socket.
+     * \param socket the TCP socket of the peer
+     * \param address the address of the peer's UDP socket
+     * \param port the port of the peer's UDP socket
+     */
+    void setDatagramPeer(QAbstractSocket* socket, QHostAddress const& address, quint16 port);
+
+    /*!
+     * \brief Returns whether messages of the specified type may be sent over the unreliable
+     * channel. These are the messages where a newer one always supersedes an older one,
+     * so losing one is harmless.
+     * \param type the message type
+     * \return whether or not the message type may be sent unreliably
+     */
+    static bool isUnreliable(MessageType type);
+
+    /*!
+     * \brief Returns the number of datagrams that were dropped because they arrived after
+     * a newer one from the same peer.
+     * \return the number of stale datagrams
+     */
+    inline qint64 staleDatagrams() const
+    {
+        return _staleDatagrams;
+    }
+
+    /*!
+     * \brief Returns the number of unreliable messages that were too large for a datagram of
+     * DATAGRAM_MAX_SIZE bytes, and were sent via TCP instead.
+     * \return the number of oversize messages
+     */
+    inline qint64 oversizeDatagramPayloads() const
+    {
+        return _oversizeDatagramPayloads;
+    }
+
+    /*!
+     * \brief Wraps an encoded payload in the length-prefixed framing used on every socket.
+     * The result may be written as-is to any number of sockets.
+     * \param payload the encoded message to frame
+     * \return the framed bytes
+     */
+    static QByteArray frame(QByteArray const& payload);
+
+    /*!
+     * \brief Returns the payload of the message currently being dispatched, exactly as it
+     * was received. This is only meaningful from within one of the onParsed methods.
+     * \return the received payload
+     */
+    inline QByteArray const& receivedPayload() const
+    {
+        return _receivedPayload;
+    }
+
+    /*!
+     * \brief Returns the socket the message currently being dispatched was received on, or on
+     * behalf of, for messages received via UDP. This is only meaningful from within one of the
+     * onParsed methods.
+     * \return the socket of the sender
+     */
+    inline QAbstractSocket* receivedSocket() const
+    {
+        return _receivedSocket;
+    }
+
+    /*!
+     * \brief Detects the wire format an encoded payload is in.
+     * \param payload the encoded payload
+     * \return the wire format the payload is encoded in
+     */
+    static WireFormat formatOf(QByteArray const& payload);
+
+    /*!
+     * \brief Returns the wire format that has been negotiated for the specified socket.
+     * \param socket the socket whose wire format to return
+     * \return the negotiated wire format, or JSON if none has been negotiated
+     */
+    WireFormat wireFormat(QAbstractSocket* socket) const;
+
+    /*!
+     * \brief Sets the wire format used to send messages via the specified socket.
+     * \param socket the socket whose wire format to set
+     * \param format the wire format to use from now on
+     */
+    void setWireFormat(QAbstractSocket* socket, WireFormat format);
+
+    /*!
+     * \brief Returns the distribution of how long queued messages waited before being flushed.
+     * Each bucket counts the messages that waited FLUSH_LATENCY_BUCKET_SIZE milliseconds
+     * longer than those in the previous bucket.
+     * \return the flush latency histogram
+     */
+    inline QVector<int> const& flushLatencyHistogram() const
+    {
+        return _flushLatencyHistogram;
+    }
+
+    /*!
+     * \brief Returns the number of queued position updates that were replaced by a newer
+     * one before they were sent.
+     * \return the number of coalesced messages
+     */
+    inline qint64 coalescedMessages() const
+    {
+        return _coalescedMessages;
+    }
+
+    /*!
+     * \brief Discards any state kept for the specified socket. This should be called
+     * once the socket has been disconnected.
+     * \param socket the socket to forget
+     */
+    virtual void forgetSocket(QAbstractSocket* socket);
 
     /*!
      * \brief Constructs a message for a client to request entry to a host's game.
      * \param color color that the client is requesting to use
      * \param username the username that the client is requesting to use
+     * \param protocolVersion the binary protocol version supported by the client, or 0 if none
+     * \param datagramPort the port of the client's UDP socket, or 0 if it only uses TCP
      * \return a message for a client to request entry to a host's game
      */
-    static QJsonObject const joinRequest(PlayerColor color, QString const& username);
+    static Message const joinRequest(PlayerColor color, QString const& username, int protocolVersion = BINARY_PROTOCOL_VERSION, quint16 datagramPort = 0);
 
     /*!
      * \brief Constructs a message for a host to accept or reject a client's game entry request.
@@ -182,17 +439,20 @@ protected:
      * \param color if the request was accepted, the color that was approved for the client
      * \param username if the request was accepted, the username that was approved for the client
      * \param error if the request was rejected, the reason for the rejection
+     * \param protocolVersion the binary protocol version both sides will switch to, or 0 to keep using JSON
+     * \param datagramPort the port of the host's UDP socket, or 0 to send everything via TCP
      * \return a message for a host to accept or reject a client's game entry request
      */
-    static QJsonObject const joinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = JoinError::NO_ERROR);
+    static Message const joinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = JoinError::NO_ERROR, int protocolVersion = 0, quint16 datagramPort = 0);
 
     /*!
      * \brief Constructs a message that indicates a player's position has been updated.
      * \param color the color of the player whose position this message concerns
      * \param position the new position of the player
+     * \param inputSequence the sequence number of the input that led to this position, or 0 if unknown
      * \return a message that indicates a player's position has been updated
      */
-    static QJsonObject const positionMessage(PlayerColor color, QPointF position);
+    static Message const positionMessage(PlayerColor color, QPointF position, quint32 inputSequence = 0);
 
     /*!
      * \brief Constructs a message that indicates a player has shot a bullet.
@@ -201,7 +461,7 @@ protected:
      * \param angle the angle at which the bullet was shot
      * \return a message that indicates a player has shot a bullet
      */
-    static QJsonObject const bulletMessage(PlayerColor color, QPointF source, qreal angle);
+    static Message const bulletMessage(PlayerColor color, QPointF source, qreal angle);
 
     /*!
      * \brief Constructs a message that indicates a player's health has changed.
@@ -210,22 +470,22 @@ protected:
      * \param hasCrown whether or not the player currently has the crown
      * \return a message that indicates a player's health has changed
      */
-    static QJsonObject const healthMessage(PlayerColor color, int health, bool hasCrown);
+    static Message const healthMessage(PlayerColor color, int health, bool hasCrown);
 
     /*!
      * \brief Constructs a message that indicates the game is starting.
      * \param gameTime the length of the game, in minutes
      * \return a message that indicates the game is starting
      */
-    static QJsonObject const gameStartMessage(int gameTime);
+    static Message const gameStartMessage(int gameTime);
 
     /*!
      * \brief Constructs a message that indicates the game is ending.
-     * \param winner the color of the player who won the game
+     * \param winner the color of the player who won the game, or NO_PLAYER if nobody did
      * \param username the username of the player who won the game
      * \return a message that indicates the game is ending
      */
-    static QJsonObject const gameEndMessage(PlayerColor winner, QString const& username);
+    static Message const gameEndMessage(PlayerColor winner, QString const& username);
 
     /*!
      * \brief Constructs a message that indicates a player has joined the game.
@@ -233,7 +493,7 @@ protected:
      * \param username the username of the player who joined the game
      * \return a message that indicates a player has joined the game
      */
-    static QJsonObject const playerJoinedMessage(PlayerColor color, QString const& username);
+    static Message const playerJoinedMessage(PlayerColor color, QString const& username);
 
     /*!
      * \brief Constructs a message that indicates a player has left the game.
@@ -241,7 +501,7 @@ protected:
      * \param username the username of the player has left the game
      * \return a message that indicates a player has left the game
      */
-    static QJsonObject const playerLeftMessage(PlayerColor color, QString const& username);
+    static Message const playerLeftMessage(PlayerColor color, QString const& username);
 
     /*!
      * \brief Constructs a message that indicates a player is sending a chat message.
@@ -250,7 +510,33 @@ protected:
      * \param body the contents of the chat message
      * \return a message that indicates a player is sending a chat message
      */
-    static QJsonObject const chatMessage(PlayerColor color, QString const& username, QString const& body);
+    static Message const chatMessage(PlayerColor color, QString const& username, QString const& body);
+
+    /*!
+     * \brief Constructs a message that carries the state of the world at one server tick.
+     * Snapshots can only be encoded in the binary wire format.
+     * \param snapshot the state of the world
+     * \param baseline a snapshot the receiver already has, to encode only the differences
+     * against; if its tick is 0, the full snapshot is sent
+     * \return a message that carries the state of the world
+     */
+    static Message const snapshotMessage(WorldSnapshot const& snapshot, WorldSnapshot const& baseline = WorldSnapshot());
+
+    /*!
+     * \brief Constructs a message that acknowledges a snapshot has been received and applied,
+     * so that the host may use it as the baseline for later snapshots.
+     * \param tick the server tick of the received snapshot
+     * \return a message that acknowledges a snapshot
+     */
+    static Message const snapshotAckMessage(quint32 tick);
+
+    /*!
+     * \brief Constructs a message that carries the map of the game, which the host sends to
+     * every client that joins. Maps can only be encoded in the binary wire format.
+     * \param map the map being played
+     * \return a message that carries the map
+     */
+    static Message const mapDataMessage(MapData const& map);
 
     /*!
      * \brief A pure virtual function defining the behavior of a client or host upon receiving
@@ -265,8 +551,10 @@ protected:
      * \param socket the socket on which the join request message was received
      * \param color the requested color of the client sending the message
      * \param username the requested username of the client sending the message
+     * \param protocolVersion the binary protocol version advertised by the client, or 0 if none
+     * \param datagramPort the port of the client's UDP socket, or 0 if it only uses TCP
      */
-    virtual void onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username);
+    virtual void onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username, int protocolVersion, quint16 datagramPort);
 
     /*!
      * \brief A client may define the behavior to be taken upon successfully parsing a join response message.
@@ -274,15 +562,18 @@ protected:
      * \param color if the join request was accepted, the approved color for the client
      * \param username if the join request was accepted, the approved username for the client
      * \param error if the join request was rejected, the reason for the rejection
+     * \param protocolVersion the binary protocol version agreed upon by the host, or 0 to keep using JSON
+     * \param datagramPort the port of the host's UDP socket, or 0 to send everything via TCP
      */
-    virtual void onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = JoinError::NO_ERROR);
+    virtual void onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = JoinError::NO_ERROR, int protocolVersion = 0, quint16 datagramPort = 0);
 
     /*!
      * \brief A host or client may define the behavior to be taken upon successfully parsing a position update message.
      * \param color the color of the player whose position the message concerns
      * \param position the new position of the player
+     * \param inputSequence the sequence number of the input that led to this position, or 0 if unknown
      */
-    virtual void onParsedPositionMessage(PlayerColor color, QPointF position);
+    virtual void onParsedPositionMessage(PlayerColor color, QPointF position, quint32 inputSequence);
 
     /*!
      * \brief A host or client may define the behavior to be taken upon successfully parsing a bullet shot message.
@@ -335,6 +626,33 @@ protected:
      */
     virtual void onParsedChatMessage(PlayerColor color, QString const& username, QString const& body);
 
+    /*!
+     * \brief A client may define the behavior to be taken upon successfully parsing a world snapshot message.
+     * \param snapshot the state of the world at the snapshot's server tick
+     */
+    virtual void onParsedSnapshotMessage(WorldSnapshot const& snapshot);
+
+    /*!
+     * \brief A host may define the behavior to be taken upon successfully parsing a snapshot acknowledgement.
+     * \param socket the socket on which the acknowledgement was received
+     * \param tick the server tick of the snapshot that the client has received
+     */
+    virtual void onParsedSnapshotAck(QAbstractSocket* socket, quint32 tick);
+
+    /*!
+     * \brief A client may define the behavior to be taken upon successfully parsing a map data message.
+     * \param map the map being played
+     */
+    virtual void onParsedMapData(MapData const& map);
+
+    /*!
+     * \brief A client may provide previously received snapshots so that delta snapshots
+     * can be decoded against them.
+     * \param tick the server tick of the baseline snapshot
+     * \return the snapshot received for that tick, or nullptr if it is no longer available
+     */
+    virtual WorldSnapshot const* snapshotBaseline(quint32 tick) const;
+
     /*!
      * \brief Tries to parse a message type from a string.
      * \param string the string to try to parse into a message type
@@ -368,97 +686,161 @@ protected slots:
      */
     void onReadyRead(QAbstractSocket* socket);
 
+    /*!
+     * \brief Writes every queued frame for every socket, one batch per socket.
+     * This is called once per network tick.
+     */
+    void flushOutbound();
+
+private slots:
+    /*!
+     * \brief Reads every pending datagram from the UDP socket and dispatches the messages
+     * in it, unless a datagram of a later tick from the same peer has already been received.
+     */
+    void onDatagramsReady();
+
 private:
+    /*!
+     * \brief The QueuedFrame struct is a framed message waiting in a socket's outbound queue.
+     */
+    struct QueuedFrame
+    {
+        MessageType type;
+        PlayerColor color;
+        QByteArray framed;
+        qint64 queuedAt;
+    };
+
+    /*!
+     * \brief The DatagramPeer struct is the UDP endpoint of a peer, along with the sequence
+     * numbers used to detect datagrams that arrive out of order.
+     */
+    struct DatagramPeer
+    {
+        QHostAddress address;
+        quint16 port = 0;
+        quint32 sentSequence = 0;
+        quint32 receivedSequence = 0;
+    };
+
+    /*!
+     * \brief Passes a decoded message to the corresponding onParsed method.
+     * \param socket the socket on which the message was received
+     * \param message the message that was received
+     */
+    void dispatchMessage(QAbstractSocket* socket, Message const& message);
+
+    /*!
+     * \brief Encodes a message as a compact JSON document.
+     * \param message the message to encode
+     * \return the encoded payload
+     */
+    static QByteArray encodeJson(Message const& message);
+
+    /*!
+     * \brief Encodes a message in the fixed binary layout of the current protocol version.
+     * \param message the message to encode
+     * \return the encoded payload
+     */
+    static QByteArray encodeBinary(Message const& message);
+
+    /*!
+     * \brief Tries to decode a binary payload into a message.
+     * \param payload the payload that was received
+     * \param message the resulting message, if decoding was successful
+     * \return whether or not the payload was able to be decoded into a message
+     */
+    static bool decodeBinary(QByteArray const& payload, Message& message);
+
     /*!
      * \brief Tries to parse a received data object into any of the possible message
      * types. This method determines the type of the message and passes it to
      * one of the other parse methods for further parsing, if applicable.
-     * \param socket the socket on which the data was received
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseMessage(QAbstractSocket* socket, QJsonObject const& message);
+    static bool parseMessage(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a join request message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param socket the socket on which the data was received
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseJoinRequest(QAbstractSocket* socket, QJsonObject const& message);
+    static bool parseJoinRequest(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a join response message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseJoinResponse(QJsonObject const& message);
+    static bool parseJoinResponse(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a position update message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parsePositionMessage(QJsonObject const& message);
+    static bool parsePositionMessage(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a bullet shot message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseBulletMessage(QJsonObject const& message);
+    static bool parseBulletMessage(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a health update message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseHealthMessage(QJsonObject const& message);
+    static bool parseHealthMessage(QJsonObject const& json, Message& message);
 
     /*!
      * \brief Tries to extract the relevant information from a game start message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseGameStartMessage(QJsonObject const& message);
+    static bool parseGameStartMessage(QJsonObject const& json, Message& message);
 
     /*!
-     * \brief Tries to extract the relevant information from a game end message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \brief Tries to extract the relevant information from a message that only carries
+     * a player's color and username (game end, player joined and player left messages).
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parseGameEndMessage(QJsonObject const& message);
+    static bool parsePlayerMessage(QJsonObject const& json, Message& message);
 
     /*!
-     * \brief Tries to extract the relevant information from a player joined message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
+     * \brief Tries to extract the relevant information from a received chat message.
+     * \param json the data object that was received
+     * \param message the resulting message, if parsing was successful
      * \return whether or not the data object was able to be parsed into a message
      */
-    bool parsePlayerJoinedMessage(QJsonObject const& message);
+    static bool parseChatMessage(QJsonObject const& json, Message& message);
 
-    /*!
-     * \brief Tries to extract the relevant information from a player left message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
-     * \return whether or not the data object was able to be parsed into a message
-     */
-    bool parsePlayerLeftMessage(QJsonObject const& message);
+    QHash<QAbstractSocket*, WireFormat> _wireFormats;
+    QByteArray _receivedPayload;
+    QAbstractSocket* _receivedSocket = nullptr;
 
-    /*!
-     * \brief Tries to extract the relevant information from a received chat message.
-     * If the message is able to be parsed, the corresponding signal is emitted.
-     * \param message the data object that was received
-     * \return whether or not the data object was able to be parsed into a message
-     */
-    bool parseChatMessage(QJsonObject const& message);
+    QHash<QAbstractSocket*, QVector<QueuedFrame>> _outboundQueues;
+    QTimer* _flushTimer;
+    QElapsedTimer _clock;
+    QVector<int> _flushLatencyHistogram;
+    qint64 _coalescedMessages = 0;
+
+    QUdpSocket* _datagramSocket;
+    QHash<QAbstractSocket*, DatagramPeer> _datagramPeers;
+    qint64 _staleDatagrams = 0;
+    qint64 _oversizeDatagramPayloads = 0;
 };
 
 #endif // NETWORKBASE_H
@@ -32,13 +32,15 @@ void NetworkClient::tryJoinGame(QHostAddress const& hostAddress, PlayerColor col
 
 void NetworkClient::leaveGame()
 {
+    // Send anything still queued for this tick before disconnecting
+    flushOutbound(_socket);
     _socket->disconnectFromHost();
     onDisconnected();
 }
 
-void NetworkClient::sendPositionUpdate(QPointF position)
+void NetworkClient::sendPositionUpdate(QPointF position, quint32 inputSequence)
 {
-    sendMessage(_socket, positionMessage(_color, position));
+    sendMessage(_socket, positionMessage(_color, position, inputSequence));
 }
 
 void NetworkClient::sendBulletUpdate(QPointF source, qreal angle)
@@ -62,13 +64,23 @@ void NetworkClient::onConnected()
     _hasGameStarted = false;
     _usernames.clear();
 
+    // Always request to join in JSON, since the host may not support the binary protocol
+    forgetSocket(_socket);
+
+    // Offer a UDP socket for real-time messages; if it cannot be opened, everything goes via TCP
+    bindDatagramSocket();
+
     _timeoutTimer->start();
-    sendMessage(_socket, joinRequest(_color, _username));
+    sendMessage(_socket, joinRequest(_color, _username, BINARY_PROTOCOL_VERSION, datagramPort()));
+    flushOutbound(_socket);
 }
 
 void NetworkClient::onDisconnected()
 {
     _timeoutTimer->stop();
+    forgetSocket(_socket);
+    closeDatagramSocket();
+    _snapshotHistory.clear();
 
     _hasJoinedGame = false;
     _hasGameStarted = false;
@@ -97,12 +109,24 @@ void NetworkClient::receivedFrom(QAbstractSocket* socket)
     }
 }
 
-void NetworkClient::onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error)
+void NetworkClient::onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error, int protocolVersion, quint16 datagramPort)
 {
     _hasJoinedGame = succeeded;
 
     if (succeeded)
     {
+        // The host only sends back a protocol version if it supports the one we advertised
+        if (protocolVersion == BINARY_PROTOCOL_VERSION)
+        {
+            setWireFormat(_socket, WireFormat::BINARY_FORMAT);
+        }
+
+        // Likewise, the host only sends back a UDP port if it accepted ours
+        if (datagramPort > 0)
+        {
+            setDatagramPeer(_socket, _socket->peerAddress(), datagramPort);
+        }
+
         _color = color;
         _username = username;
 
@@ -114,7 +138,7 @@ void NetworkClient::onParsedJoinResponse(bool succeeded, PlayerColor color, QStr
     }
 }
 
-void NetworkClient::onParsedPositionMessage(PlayerColor color, QPointF position)
+void NetworkClient::onParsedPositionMessage(PlayerColor color, QPointF position, quint32)
 {
     emit positionUpdated(color, position);
 }
@@ -157,3 +181,36 @@ void NetworkClient::onParsedChatMessage(PlayerColor color, QString const& userna
 {
     emit receivedChatMessage(color, username, body);
 }
+
+void NetworkClient::onParsedSnapshotMessage(WorldSnapshot const& snapshot)
+{
+    // Keep the snapshot as a possible baseline and let the host know it arrived
+    if (_snapshotHistory.size() >= SNAPSHOT_HISTORY_SIZE)
+    {
+        _snapshotHistory.removeFirst();
+    }
+    _snapshotHistory.append(snapshot);
+    sendMessage(_socket, snapshotAckMessage(snapshot.tick));
+
+    // Positions in the snapshot reach listeners only through it, timestamped with the
+    //  snapshot's server time; they are not also announced as position updates
+    emit snapshotReceived(snapshot);
+}
+
+void NetworkClient::onParsedMapData(MapData const& map)
+{
+    emit mapReceived(map);
+}
+
+WorldSnapshot const* NetworkClient::snapshotBaseline(quint32 tick) const
+{
+    for (WorldSnapshot const& snapshot : _snapshotHistory)
+    {
+        if (snapshot.tick == tick)
+        {
+            return &snapshot;
+        }
+    }
+
+    return nullptr;
+}
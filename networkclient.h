@@ -37,7 +37,7 @@ public slots:
     void tryJoinGame(QHostAddress const& hostAddress, PlayerColor color, QString const& username, quint16 port = PORT_NUMBER);
     void leaveGame();
 
-    void sendPositionUpdate(QPointF position);
+    void sendPositionUpdate(QPointF position, quint32 inputSequence = 0);
     void sendBulletUpdate(QPointF source, qreal angle);
     void sendHealthUpdate(PlayerColor color, int health, bool hasCrown);
     void sendChatMessage(QString const& body);
@@ -51,8 +51,8 @@ signals:
 protected:
     void receivedFrom(QAbstractSocket* socket);
 
-    void onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = NO_ERROR);
-    void onParsedPositionMessage(PlayerColor color, QPointF position);
+    void onParsedJoinResponse(bool succeeded, PlayerColor color, QString const& username, JoinError error = NO_ERROR, int protocolVersion = 0, quint16 datagramPort = 0);
+    void onParsedPositionMessage(PlayerColor color, QPointF position, quint32 inputSequence);
     void onParsedBulletMessage(PlayerColor color, QPointF source, qreal angle);
     void onParsedHealthMessage(PlayerColor color, int health, bool hasCrown);
     void onParsedGameStartMessage(int gameTime);
@@ -60,6 +60,9 @@ protected:
     void onParsedPlayerJoinedMessage(PlayerColor color, QString const& username);
     void onParsedPlayerLeftMessage(PlayerColor color, QString const& username);
     void onParsedChatMessage(PlayerColor color, QString const& username, QString const& body);
+    void onParsedSnapshotMessage(WorldSnapshot const& snapshot);
+    void onParsedMapData(MapData const& map);
+    WorldSnapshot const* snapshotBaseline(quint32 tick) const;
 
 private slots:
     void onConnected();
@@ -76,6 +79,11 @@ private:
     QString _username = QStringLiteral("NULL");
 
     QMap<PlayerColor, QString> _usernames;
+
+    /*!
+     * \brief The most recently received snapshots, which the host may encode deltas against.
+     */
+    QVector<WorldSnapshot> _snapshotHistory;
 };
 
 #endif // NETWORKCLIENT_H
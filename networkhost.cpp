@@ -1,11 +1,24 @@
 #include "networkhost.h"
 
+#include <QRectF>
+
 NetworkHost::NetworkHost(QObject* parent)
     : NetworkBase(parent)
     , _server(new QTcpServer(this))
+    , _statisticsTimer(new QTimer(this))
+    , _tickTimer(new QTimer(this))
 {
     // Connect server signals
     connect(_server, &QTcpServer::newConnection, this, &NetworkHost::onNewConnection);
+
+    // Sample broadcast statistics once per second
+    _statisticsTimer->setInterval(1000);
+    connect(_statisticsTimer, &QTimer::timeout, this, &NetworkHost::updateStatistics);
+
+    // The tick timer only wakes the host up; how many ticks to run is measured separately
+    _tickTimer->setTimerType(Qt::PreciseTimer);
+    _tickTimer->setInterval(1000 / _tickRate);
+    connect(_tickTimer, &QTimer::timeout, this, &NetworkHost::onTickTimer);
 }
 
 void NetworkHost::onNewConnection()
@@ -48,6 +61,19 @@ void NetworkHost::onDisconnected(QAbstractSocket* socket)
         _sockets.remove(color);
         _usernames.remove(color);
 
+        // Remove player from the world
+        for (int i = 0; i < _world.players.size(); i++)
+        {
+            if (_world.players[i].color == color)
+            {
+                _world.players.remove(i);
+                break;
+            }
+        }
+        _gameWorld.removePlayer(color);
+        _lastPositionTimes.remove(color);
+        _nextShotTimes.remove(color);
+
         qDebug() << "player left" << username;
 
         sendMessageToClients(playerLeftMessage(color, username));
@@ -61,6 +87,8 @@ void NetworkHost::onDisconnected(QAbstractSocket* socket)
     timer->deleteLater();
 
     // Delete socket
+    forgetSocket(socket);
+    _ackedTicks.remove(socket);
     _tempConnected.removeOne(socket);
     socket->deleteLater();
 }
@@ -82,29 +110,97 @@ void NetworkHost::onError(QAbstractSocket* socket, QAbstractSocket::SocketError
 
 void NetworkHost::startHosting(PlayerColor color, QString const& username, int maxPlayers, QHostAddress const& hostAddress, quint16 port)
 {
-    _sockets.clear();
-    _usernames.clear();
-    _tempConnected.clear();
-
+    _dedicated = false;
     _color = color;
     _username = username;
+
+    listen(maxPlayers, hostAddress, port);
+
+    // Start the world with only the hosting player in it
     _usernames[color] = username;
+    worldPlayer(color);
+
+    emit startedHosting(color, username);
+}
+
+bool NetworkHost::startDedicatedHosting(int maxPlayers, QHostAddress const& hostAddress, quint16 port)
+{
+    // The host's own color only labels what it sends; no player has it until one joins as it
+    _dedicated = true;
+    _color = PlayerColor::Red;
+    _username = QStringLiteral("Server");
+
+    if (!listen(maxPlayers, hostAddress, port))
+    {
+        return false;
+    }
+
+    emit startedHosting(_color, _username);
+    return true;
+}
+
+bool NetworkHost::listen(int maxPlayers, QHostAddress const& hostAddress, quint16 port)
+{
+    _sockets.clear();
+    _usernames.clear();
+    _tempConnected.clear();
 
     _maxPlayers = maxPlayers;
     _hosting = true;
     _hasGameStarted = false;
 
-    _server->listen(hostAddress, port);
-    emit startedHosting(color, username);
+    _world = WorldSnapshot();
+    _gameWorld = GameWorld();
+    _gameWorld.loadMap(_map);
+    _healthKitWave = 0;
+    _lastPositionTimes.clear();
+    _nextShotTimes.clear();
+    _snapshotHistory.clear();
+    _ackedTicks.clear();
+
+    _lastTickAt = 0;
+    _tickAccumulator = 0;
+    _droppedTicks = 0;
+    _simulatedTime = 0;
+    _ticksSinceSend = 0;
+    _lastTickTime = 0;
+    _averageTickTime = 0.0;
+    _maxTickTime = 0;
+    _tickClock.start();
+    _tickTimer->start();
+
+    _serializations = 0;
+    _framesSent = 0;
+    _lastSerializationsSaved = 0;
+    _serializationsSavedPerSecond = 0;
+    _statisticsTimer->start();
+
+    bool listening = _server->listen(hostAddress, port);
+
+    // Real-time messages use a UDP socket on the same port, for clients that support it
+    bindDatagramSocket(hostAddress, port);
+
+    return listening;
 }
 
 void NetworkHost::stopHosting()
 {
+    if (!_dedicated)
+    {
+        sendMessageToClients(gameEndMessage(_color, _username));
+    }
+    else if (_hasGameStarted)
+    {
+        // A dedicated host is not a player, so a game cut short goes to whoever holds the crown
+        PlayerSnapshot const* holder = _world.crownHolder();
+        PlayerColor winner = holder != nullptr ? holder->color : NO_PLAYER;
+        sendMessageToClients(gameEndMessage(winner, holder != nullptr ? _usernames.value(winner) : QString()));
+    }
+    flushOutbound();
+
     _hosting = false;
     _hasGameStarted = false;
 
-    sendMessageToClients(gameEndMessage(_color, _username));
-
     for (QAbstractSocket* clientSocket : _sockets)
     {
         clientSocket->disconnectFromHost();
@@ -116,6 +212,9 @@ void NetworkHost::stopHosting()
     _tempConnected.clear();
 
     _server->close();
+    closeDatagramSocket();
+    _statisticsTimer->stop();
+    _tickTimer->stop();
     emit stoppedHosting();
 }
 
@@ -128,6 +227,18 @@ void NetworkHost::startGame(int gameTime)
 
     _hasGameStarted = true;
 
+    // Every game starts with everyone at full health at their spawn point and the crown in place
+    _gameWorld.reset();
+    _gameWorld.placeCrown(_map.crownStart);
+    _nextHealthKitWaveAt = _gameWorld.time() + HEALTH_KIT_WAVE_INTERVAL;
+    _healthKitWave = 0;
+    for (PlayerSnapshot& player : _world.players)
+    {
+        player.health = PLAYER_MAX_HEALTH;
+        player.hasCrown = false;
+        player.isDead = false;
+    }
+
     sendMessageToClients(gameStartMessage(gameTime));
     emit gameStarted(gameTime);
 }
@@ -140,19 +251,33 @@ void NetworkHost::endGame(PlayerColor winner, QString const& username)
     emit gameEnded(winner, username);
 }
 
-void NetworkHost::sendPositionUpdate(QPointF position)
+void NetworkHost::sendPositionUpdate(QPointF position, quint32 inputSequence)
 {
-    sendMessageToClients(positionMessage(_color, position));
+    // Positions reach clients through the next snapshot
+    updatePlayerPosition(_color, position, inputSequence, /* validate */ false);
 }
 
 void NetworkHost::sendBulletUpdate(QPointF source, qreal angle)
 {
+    if (!spawnBullet(_color, source, angle, /* validate */ false))
+    {
+        return;
+    }
+
     sendMessageToClients(bulletMessage(_color, source, angle));
 }
 
 void NetworkHost::sendHealthUpdate(PlayerColor color, int health, bool hasCrown)
 {
-    sendMessageToClients(healthMessage(color, health, hasCrown));
+    // Only players already in the game have health to set
+    if (_world.player(color) == nullptr)
+    {
+        return;
+    }
+
+    // The host decides health itself, so this overrides the world instead of being checked
+    _gameWorld.setPlayerHealth(color, health, hasCrown);
+    syncPlayerHealth();
 }
 
 void NetworkHost::sendChatMessage(QString const& body)
@@ -176,10 +301,21 @@ void NetworkHost::receivedFrom(QAbstractSocket* socket)
     }
 }
 
-void NetworkHost::onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username)
+void NetworkHost::onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username, int protocolVersion, quint16 datagramPort)
 {
+    // A socket only ever plays as one player, so asking again would add a second player for it
+    if (_sockets.values().contains(socket))
+    {
+        return;
+    }
+
     JoinError error = JoinError::NO_ERROR;
 
+    if (color < PlayerColor::Red || color > PlayerColor::Gray)
+    {
+        error = static_cast<JoinError>(JoinError::INVALID_COLOR);
+    }
+
     if (_usernames.size() >= _maxPlayers)
     {
         error = static_cast<JoinError>(JoinError::GAME_FULL);
@@ -197,13 +333,41 @@ void NetworkHost::onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color
 
     bool succeeded = (error == JoinError::NO_ERROR);
 
-    // Inform user whether join is accepted or rejected
-    sendMessage(socket, joinResponse(succeeded, color, username, error));
+    // Switch to the binary protocol only if the client speaks the same version;
+    //  older clients keep receiving JSON
+    bool useBinary = succeeded && (protocolVersion == BINARY_PROTOCOL_VERSION);
+
+    // Only binary clients that opened a UDP socket receive real-time messages via UDP
+    bool useDatagrams = useBinary && datagramPort > 0 && this->datagramPort() > 0;
+
+    // Inform user whether join is accepted or rejected. The response itself is
+    //  still sent as JSON, since the client has not switched formats yet.
+    sendMessage(socket, joinResponse(succeeded, color, username, error,
+                                     useBinary ? BINARY_PROTOCOL_VERSION : 0,
+                                     useDatagrams ? this->datagramPort() : 0));
+    flushOutbound(socket);
 
     if (succeeded)
     {
+        if (useBinary)
+        {
+            setWireFormat(socket, WireFormat::BINARY_FORMAT);
+        }
+
+        if (useDatagrams)
+        {
+            setDatagramPeer(socket, socket->peerAddress(), datagramPort);
+        }
+
+        // Stream the map to the new player, who may not have it
+        if (useBinary && !_map.walls.isEmpty())
+        {
+            sendMessage(socket, mapDataMessage(_map));
+        }
+
         _usernames[color] = username;
         _sockets[color] = socket;
+        worldPlayer(color);
 
         // Notify other clients of new player
         sendMessageToClients(playerJoinedMessage(color, username));
@@ -211,41 +375,462 @@ void NetworkHost::onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color
     }
 }
 
-void NetworkHost::onParsedPositionMessage(PlayerColor color, QPointF position)
+bool NetworkHost::isFromPlayer(PlayerColor color) const
+{
+    QAbstractSocket* socket = _sockets.value(color);
+    return socket != nullptr && socket == receivedSocket();
+}
+
+void NetworkHost::onParsedPositionMessage(PlayerColor color, QPointF position, quint32 inputSequence)
 {
-    // Forward position to all players except sender
-    sendMessageToClients(positionMessage(color, position), /* except */ _sockets[color]);
-    emit positionUpdated(color, position);
+    if (!isFromPlayer(color))
+    {
+        return;
+    }
+
+    // Positions are no longer relayed as they arrive; other players receive
+    //  them through the next snapshot
+    QPointF accepted = updatePlayerPosition(color, position, inputSequence, /* validate */ true);
+    emit positionUpdated(color, accepted);
 }
 
 void NetworkHost::onParsedBulletMessage(PlayerColor color, QPointF source, qreal angle)
 {
+    if (!isFromPlayer(color) || !spawnBullet(color, source, angle, /* validate */ true))
+    {
+        return;
+    }
+
     // Forward bullet to all players except sender
-    sendMessageToClients(bulletMessage(color, source, angle), /* except */ _sockets[color]);
+    forwardToClients(bulletMessage(color, source, angle), /* sender */ _sockets.value(color));
     emit bulletUpdated(color, source, angle);
 }
 
-void NetworkHost::onParsedHealthMessage(PlayerColor color, int health, bool hasCrown)
+void NetworkHost::onParsedHealthMessage(PlayerColor, int, bool)
 {
-    // Forward health update to all players except sender
-    sendMessageToClients(healthMessage(color, health, hasCrown), /* except */ _sockets[color]);
-    emit healthUpdated(color, health, hasCrown);
+    // Health and the crown are decided by the host's world, which tells every client about
+    //  changes itself; what clients report is only their own guess
 }
 
 void NetworkHost::onParsedChatMessage(PlayerColor color, QString const& username, QString const& body)
 {
+    if (!isFromPlayer(color))
+    {
+        return;
+    }
+
     // Forward chat message to all clients
-    sendMessageToClients(chatMessage(color, username, body), /* except */ _sockets[color]);
+    forwardToClients(chatMessage(color, username, body), /* sender */ _sockets.value(color));
     emit receivedChatMessage(color, username, body);
 }
 
-void NetworkHost::sendMessageToClients(QJsonObject const& message, QAbstractSocket* except)
+void NetworkHost::onParsedSnapshotAck(QAbstractSocket* socket, quint32 tick)
+{
+    // Only players who have joined are sent snapshots to acknowledge
+    if (!_sockets.values().contains(socket))
+    {
+        return;
+    }
+
+    // Acknowledgements may arrive out of order; only ever move the baseline forward
+    if (tick > _ackedTicks.value(socket, 0))
+    {
+        _ackedTicks[socket] = tick;
+    }
+}
+
+void NetworkHost::sendMessageToClients(Message const& message, QAbstractSocket* except)
+{
+    QByteArray frames[WireFormat::BINARY_FORMAT + 1];
+    broadcastFrames(message, frames, except);
+}
+
+void NetworkHost::forwardToClients(Message const& message, QAbstractSocket* sender)
+{
+    // Clients using the same wire format as the sender receive the exact bytes that
+    //  were received, so the message only has to be encoded for the other format
+    QByteArray frames[WireFormat::BINARY_FORMAT + 1];
+    if (!receivedPayload().isEmpty())
+    {
+        frames[formatOf(receivedPayload())] = frame(receivedPayload());
+    }
+
+    broadcastFrames(message, frames, sender);
+}
+
+void NetworkHost::broadcastFrames(Message const& message, QByteArray (&frames)[WireFormat::BINARY_FORMAT + 1], QAbstractSocket* except)
+{
+    for (auto it = _sockets.cbegin(); it != _sockets.cend(); ++it)
+    {
+        QAbstractSocket* clientSocket = it.value();
+        if (clientSocket == except)
+        {
+            continue;
+        }
+
+        // Encode the message at most once per wire format; every client using
+        //  that format shares the same implicitly shared frame buffer
+        WireFormat format = wireFormat(clientSocket);
+        QByteArray& framed = frames[format];
+
+        if (framed.isEmpty())
+        {
+            framed = frame(encode(message, format));
+            _serializations++;
+        }
+
+        queueFrame(clientSocket, message.type, message.color, framed);
+        _framesSent++;
+    }
+}
+
+void NetworkHost::updateStatistics()
+{
+    // Sending each frame individually would have required one serialization per frame
+    qint64 saved = _framesSent - _serializations;
+
+    _serializationsSavedPerSecond = static_cast<int>(saved - _lastSerializationsSaved);
+    _lastSerializationsSaved = saved;
+}
+
+void NetworkHost::setTickRate(int ticksPerSecond)
+{
+    _tickRate = qBound(1, ticksPerSecond, 1000);
+    _tickTimer->setInterval(1000 / _tickRate);
+}
+
+void NetworkHost::setSendRate(int snapshotsPerSecond)
+{
+    _sendRate = qBound(1, snapshotsPerSecond, _tickRate);
+}
+
+void NetworkHost::setMap(MapData const& map)
+{
+    _map = map;
+    _gameWorld.loadMap(_map);
+
+    // Clients that only speak JSON keep the map they have
+    for (QAbstractSocket* socket : qAsConst(_sockets))
+    {
+        if (wireFormat(socket) == WireFormat::BINARY_FORMAT)
+        {
+            sendMessage(socket, mapDataMessage(_map));
+        }
+    }
+}
+
+void NetworkHost::onTickTimer()
+{
+    // Run as many fixed-length ticks as real time has passed, so the simulation
+    //  rate does not depend on how accurately the timer fires
+    qint64 now = _tickClock.nsecsElapsed();
+    qint64 tickLength = 1000000000 / _tickRate;
+
+    _tickAccumulator += now - _lastTickAt;
+    _lastTickAt = now;
+
+    int ticks = 0;
+    while (_tickAccumulator >= tickLength)
+    {
+        if (ticks >= SERVER_MAX_CATCH_UP_TICKS)
+        {
+            // Drop the rest of the backlog instead of falling further behind
+            _droppedTicks += _tickAccumulator / tickLength;
+            _tickAccumulator %= tickLength;
+            break;
+        }
+
+        tick();
+        _tickAccumulator -= tickLength;
+        ticks++;
+    }
+}
+
+void NetworkHost::tick()
+{
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    qint64 now = _tickClock.elapsed();
+
+    _world.tick++;
+    _world.time = static_cast<quint32>(now);
+
+    // The world advances in steps of its own, as many as fit in the time since the last tick
+    int steps = 0;
+    while (_simulatedTime + SIMULATION_STEP <= now)
+    {
+        if (steps >= SIMULATION_MAX_CATCH_UP_STEPS)
+        {
+            _simulatedTime = now;
+            break;
+        }
+
+        if (_hasGameStarted && _gameWorld.time() >= _nextHealthKitWaveAt)
+        {
+            spawnHealthKitWave();
+        }
+
+        _gameWorld.step();
+        _simulatedTime += SIMULATION_STEP;
+        steps++;
+    }
+
+    syncPlayerHealth();
+
+    // Players who have stopped sending positions are no longer moving
+    for (PlayerSnapshot& player : _world.players)
+    {
+        if (now - _lastPositionTimes.value(player.color, now) > 2 * NETWORK_UPDATE_RATE)
+        {
+            player.velocity = QPointF();
+        }
+    }
+
+    _ticksSinceSend++;
+    if (_ticksSinceSend >= qMax(1, _tickRate / _sendRate))
+    {
+        _ticksSinceSend = 0;
+        sendSnapshot();
+    }
+
+    _lastTickTime = frameTimer.nsecsElapsed() / 1000;
+    _maxTickTime = qMax(_maxTickTime, _lastTickTime);
+    _averageTickTime += (_lastTickTime - _averageTickTime) * 0.05;
+}
+
+void NetworkHost::sendSnapshot()
+{
+    // Clients that acknowledged the same baseline share the same encoded delta
+    QHash<quint32, QByteArray> snapshotFrames;
+    QMap<PlayerColor, QByteArray> positionFrames;
+
+    for (auto it = _sockets.cbegin(); it != _sockets.cend(); ++it)
+    {
+        QAbstractSocket* clientSocket = it.value();
+
+        if (wireFormat(clientSocket) == WireFormat::BINARY_FORMAT)
+        {
+            WorldSnapshot const* baseline = sentSnapshot(_ackedTicks.value(clientSocket, 0));
+            quint32 baselineTick = baseline ? baseline->tick : 0;
+
+            QByteArray& snapshotFrame = snapshotFrames[baselineTick];
+            if (snapshotFrame.isEmpty())
+            {
+                Message const message = baseline ? snapshotMessage(_world, *baseline) : snapshotMessage(_world);
+                snapshotFrame = frame(encode(message, WireFormat::BINARY_FORMAT));
+                _serializations++;
+            }
+
+            queueFrame(clientSocket, MessageType::WORLD_SNAPSHOT, _color, snapshotFrame);
+            _framesSent++;
+            continue;
+        }
+
+        // Clients without the binary protocol cannot read snapshots, so they keep
+        //  receiving one position update per player instead
+        for (PlayerSnapshot const& player : qAsConst(_world.players))
+        {
+            if (player.color == it.key())
+            {
+                continue;
+            }
+
+            QByteArray& positionFrame = positionFrames[player.color];
+            if (positionFrame.isEmpty())
+            {
+                positionFrame = frame(encode(positionMessage(player.color, player.position), WireFormat::JSON_FORMAT));
+                _serializations++;
+            }
+
+            queueFrame(clientSocket, MessageType::POSITION_UPDATE, player.color, positionFrame);
+            _framesSent++;
+        }
+    }
+
+    // Remember what was sent, so later snapshots can be encoded against it once acknowledged
+    if (_snapshotHistory.size() >= SNAPSHOT_HISTORY_SIZE)
+    {
+        _snapshotHistory.removeFirst();
+    }
+    _snapshotHistory.append(_world);
+}
+
+WorldSnapshot const* NetworkHost::sentSnapshot(quint32 tick) const
+{
+    if (tick == 0)
+    {
+        return nullptr;
+    }
+
+    for (WorldSnapshot const& snapshot : _snapshotHistory)
+    {
+        if (snapshot.tick == tick)
+        {
+            return &snapshot;
+        }
+    }
+
+    return nullptr;
+}
+
+PlayerSnapshot& NetworkHost::worldPlayer(PlayerColor color)
+{
+    if (PlayerSnapshot* player = _world.player(color))
+    {
+        return *player;
+    }
+
+    PlayerSnapshot player;
+    player.color = color;
+    player.health = PLAYER_MAX_HEALTH;
+    _world.players.append(player);
+
+    // Players move themselves, so the world only positions them where they say they are
+    QPointF spawn = _map.spawn(static_cast<int>(color));
+    _gameWorld.addPlayer(color, spawn);
+    _gameWorld.setPlayerPosition(color, spawn);
+
+    return _world.players.last();
+}
+
+bool NetworkHost::spawnBullet(PlayerColor shooter, QPointF source, qreal angle, bool validate)
+{
+    // The dead cannot shoot
+    PlayerState const* state = _gameWorld.player(shooter);
+    if (state == nullptr || state->isDead)
+    {
+        return false;
+    }
+
+    if (validate)
+    {
+        // Bullets leave from the center of the shooter
+        QPointF offset = source - (state->position + QPointF(PLAYER_SIZE, PLAYER_SIZE) / 2);
+        if (!qIsFinite(source.x()) || !qIsFinite(source.y()) || !qIsFinite(angle)
+            || QPointF::dotProduct(offset, offset) > BULLET_MAX_SOURCE_DISTANCE * BULLET_MAX_SOURCE_DISTANCE)
+        {
+            return false;
+        }
+
+        // Shots may arrive a few at a time, but never faster on average than the fire interval
+        qint64 now = _gameWorld.time();
+        qint64 nextShotAt = qMax(_nextShotTimes.value(shooter, now), now);
+        if (nextShotAt - now > (BULLET_FIRE_BURST - 1) * BULLET_FIRE_INTERVAL)
+        {
+            return false;
+        }
+        _nextShotTimes[shooter] = nextShotAt + BULLET_FIRE_INTERVAL;
+    }
+
+    _gameWorld.spawnBullet(shooter, source, angle);
+    return true;
+}
+
+void NetworkHost::spawnHealthKitWave()
 {
-    for (QAbstractSocket* clientSocket : _sockets.values())
+    _gameWorld.clearHealthKits();
+
+    if (!_map.healthKitWaves.isEmpty())
     {
-        if (clientSocket != except)
+        for (QPointF const& position : _map.healthKitWaves[_healthKitWave % _map.healthKitWaves.size()])
         {
-            sendMessage(clientSocket, message);
+            _gameWorld.spawnHealthKit(position);
         }
     }
+
+    _healthKitWave++;
+    _nextHealthKitWaveAt += HEALTH_KIT_WAVE_INTERVAL;
+}
+
+void NetworkHost::syncPlayerHealth()
+{
+    for (PlayerSnapshot& player : _world.players)
+    {
+        PlayerState const* state = _gameWorld.player(player.color);
+        if (state == nullptr)
+        {
+            continue;
+        }
+
+        if (player.health == state->health && player.hasCrown == state->hasCrown && player.isDead == state->isDead)
+        {
+            continue;
+        }
+
+        player.health = state->health;
+        player.hasCrown = state->hasCrown;
+        player.isDead = state->isDead;
+
+        // Every client, including the player's own, learns the outcome reliably
+        sendMessageToClients(healthMessage(player.color, player.health, player.hasCrown));
+        emit healthUpdated(player.color, player.health, player.hasCrown);
+    }
+}
+
+QPointF NetworkHost::updatePlayerPosition(PlayerColor color, QPointF position, quint32 inputSequence, bool validate)
+{
+    PlayerSnapshot& player = worldPlayer(color);
+    PlayerState const* state = _gameWorld.player(color);
+    qint64 now = _tickClock.elapsed();
+    qint64 elapsed = now - _lastPositionTimes.value(color, now);
+
+    // Inputs that arrive after a newer one have already been superseded
+    if (inputSequence != 0 && inputSequence <= player.lastInput)
+    {
+        return player.position;
+    }
+
+    // Dead players are moved off the map and back to their spawn point, which is not
+    //  a move the limits apply to
+    if (validate && state != nullptr && !state->isDead)
+    {
+        // Every check below would let a position that is not a number through
+        if (!qIsFinite(position.x()) || !qIsFinite(position.y()))
+        {
+            return player.position;
+        }
+
+        // Moves are checked from where the world last put the player, which is its spawn
+        //  point after a respawn or the start of a game
+        QPointF from = state->position;
+
+        // Allow for updates that were delayed by up to one network tick
+        qreal maxDistance = PLAYER_MAX_VELOCITY * PLAYER_SPEED_TOLERANCE
+                            * (elapsed + NETWORK_UPDATE_RATE) / SIMULATION_STEP;
+        QPointF offset = position - from;
+        qreal distance = qSqrt(QPointF::dotProduct(offset, offset));
+
+        if (distance > maxDistance)
+        {
+            position = from + offset * (maxDistance / distance);
+        }
+
+        // A move through a wall leaves the player where it was
+        if (!_gameWorld.isPathClear(from, position))
+        {
+            position = from;
+        }
+    }
+
+    // Estimate the velocity from the distance travelled since the last update
+    if (elapsed > 0)
+    {
+        player.velocity = (position - player.position) * (1000.0 / elapsed);
+    }
+
+    player.position = position;
+    if (inputSequence != 0)
+    {
+        player.lastInput = inputSequence;
+    }
+    _lastPositionTimes[color] = now;
+
+    // The world keeps dead players out of the way until it respawns them itself
+    if (state != nullptr && !state->isDead)
+    {
+        _gameWorld.setPlayerPosition(color, position);
+    }
+
+    return position;
 }
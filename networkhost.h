@@ -1,8 +1,10 @@
 #ifndef NETWORKHOST_H
 #define NETWORKHOST_H
 
+#include "gameworld.h"
 #include "networkbase.h"
 
+#include <QElapsedTimer>
 #include <QNetworkProxy>
 #include <QTcpServer>
 #include <QTcpSocket>
@@ -30,23 +32,158 @@ public:
         return _hosting;
     }
 
+    /*!
+     * \brief Returns the port the host is listening on, which is chosen by the system
+     * when hosting was started on port 0.
+     */
+    inline quint16 port() const
+    {
+        return _server->serverPort();
+    }
+
+    /*!
+     * \brief Returns whether the host only relays the game, without a player of its own.
+     */
+    inline bool isDedicated() const
+    {
+        return _dedicated;
+    }
+
+    /*!
+     * \brief Returns the username of every player in the game, by color.
+     */
+    inline QMap<PlayerColor, QString> const& usernames() const
+    {
+        return _usernames;
+    }
+
     inline bool hasGameStarted() const
     {
         return _hasGameStarted;
     }
 
+    /*!
+     * \brief Returns how many message serializations were avoided during the last
+     * full second by encoding each broadcast once and forwarding received bytes as-is.
+     * \return the number of serializations saved per second
+     */
+    inline int serializationsSavedPerSecond() const
+    {
+        return _serializationsSavedPerSecond;
+    }
+
+    /*!
+     * \brief Returns the authoritative state of the world as of the last server tick.
+     * \return the state of the world
+     */
+    inline WorldSnapshot const& world() const
+    {
+        return _world;
+    }
+
+    /*!
+     * \brief Returns the map being played, which every client receives when it joins.
+     * \return the map
+     */
+    inline MapData const& map() const
+    {
+        return _map;
+    }
+
+    inline int tickRate() const
+    {
+        return _tickRate;
+    }
+
+    inline int sendRate() const
+    {
+        return _sendRate;
+    }
+
+    /*!
+     * \brief Returns how long the last server tick took to run, in microseconds.
+     */
+    inline qint64 lastTickTime() const
+    {
+        return _lastTickTime;
+    }
+
+    /*!
+     * \brief Returns the moving average of how long server ticks take to run, in microseconds.
+     */
+    inline qint64 averageTickTime() const
+    {
+        return static_cast<qint64>(_averageTickTime);
+    }
+
+    /*!
+     * \brief Returns the longest any server tick has taken to run since hosting started, in microseconds.
+     */
+    inline qint64 maxTickTime() const
+    {
+        return _maxTickTime;
+    }
+
+    /*!
+     * \brief Returns the number of server ticks skipped since hosting started, because the host
+     * fell further behind than it could catch up on.
+     */
+    inline qint64 droppedTicks() const
+    {
+        return _droppedTicks;
+    }
+
+    /*!
+     * \brief Returns the world the host simulates. Bullets, damage, deaths, respawns, the crown and
+     * health kits are all decided by it; players only report where they have moved to.
+     * \return the simulated world
+     */
+    inline GameWorld const& gameWorld() const
+    {
+        return _gameWorld;
+    }
+
 public slots:
     void startHosting(PlayerColor color, QString const& username, int maxPlayers = DEFAULT_MAX_PLAYERS, QHostAddress const& hostAddress = QHostAddress::Any, quint16 port = PORT_NUMBER);
+
+    /*!
+     * \brief Starts hosting a game the host does not play in, for a server without a player.
+     * Every color is left for clients to join as.
+     * \param maxPlayers the number of players that may join
+     * \param hostAddress the address to listen on
+     * \param port the port to listen on
+     * \return whether or not the host was able to listen on the port
+     */
+    bool startDedicatedHosting(int maxPlayers = DEFAULT_MAX_PLAYERS, QHostAddress const& hostAddress = QHostAddress::Any, quint16 port = PORT_NUMBER);
     void stopHosting();
 
     void startGame(int gameTime);
     void endGame(PlayerColor winner, QString const& username);
 
-    void sendPositionUpdate(QPointF position);
+    void sendPositionUpdate(QPointF position, quint32 inputSequence = 0);
     void sendBulletUpdate(QPointF source, qreal angle);
     void sendHealthUpdate(PlayerColor color, int health, bool hasCrown);
     void sendChatMessage(QString const& body);
 
+    /*!
+     * \brief Sets how many fixed-length simulation ticks the host runs per second.
+     * \param ticksPerSecond the number of ticks per second
+     */
+    void setTickRate(int ticksPerSecond);
+
+    /*!
+     * \brief Sets how many world snapshots the host sends to each client per second.
+     * The send rate is rounded so that a snapshot is sent every whole number of ticks.
+     * \param snapshotsPerSecond the number of snapshots per second
+     */
+    void setSendRate(int snapshotsPerSecond);
+
+    /*!
+     * \brief Sets the map being played, and sends it to every client already in the game.
+     * \param map the map
+     */
+    void setMap(MapData const& map);
+
 signals:
     void connected(QAbstractSocket* socket);
     void disconnected(QAbstractSocket* socket);
@@ -58,11 +195,12 @@ signals:
 protected slots:
     void receivedFrom(QAbstractSocket* socket);
 
-    void onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username);
-    void onParsedPositionMessage(PlayerColor color, QPointF position);
+    void onParsedJoinRequest(QAbstractSocket* socket, PlayerColor color, QString const& username, int protocolVersion, quint16 datagramPort);
+    void onParsedPositionMessage(PlayerColor color, QPointF position, quint32 inputSequence);
     void onParsedBulletMessage(PlayerColor color, QPointF source, qreal angle);
     void onParsedHealthMessage(PlayerColor color, int health, bool hasCrown);
     void onParsedChatMessage(PlayerColor color, QString const& username, QString const& body);
+    void onParsedSnapshotAck(QAbstractSocket* socket, quint32 tick);
 
 private slots:
     void onNewConnection();
@@ -70,8 +208,94 @@ private slots:
     void onDisconnected(QAbstractSocket* socket);
     void onError(QAbstractSocket* socket, QAbstractSocket::SocketError socketError);
 
+    void updateStatistics();
+    void onTickTimer();
+
 private:
-    void sendMessageToClients(QJsonObject const& message, QAbstractSocket* except = nullptr);
+    /*!
+     * \brief Resets the game and the world, and starts listening for players.
+     * \return whether or not the host was able to listen on the port
+     */
+    bool listen(int maxPlayers, QHostAddress const& hostAddress, quint16 port);
+
+    /*!
+     * \brief Advances the world by one fixed-length tick, running as many simulation steps as
+     * fit, and sends a snapshot to every client if one is due.
+     */
+    void tick();
+
+    /*!
+     * \brief Sends the current state of the world to every client. Each binary client receives
+     * only what changed since the last snapshot it acknowledged, or the full snapshot if it has
+     * not acknowledged one that is still in the history. Clients that do not speak the binary
+     * protocol receive one position update per player instead.
+     */
+    void sendSnapshot();
+
+    /*!
+     * \brief Returns a snapshot that was recently sent to clients.
+     * \param tick the server tick of the snapshot
+     * \return the snapshot, or nullptr if it is no longer in the history
+     */
+    WorldSnapshot const* sentSnapshot(quint32 tick) const;
+
+    /*!
+     * \brief Returns whether the message being dispatched was sent by the player with the
+     * specified color. Messages from sockets that have not joined, or that claim to be from
+     * another player, are dropped instead of being applied or forwarded.
+     * \param color the color the message claims to be from
+     * \return whether or not the sender has joined as that color
+     */
+    bool isFromPlayer(PlayerColor color) const;
+
+    /*!
+     * \brief Returns the world state of the player with the specified color, adding
+     * the player to the world if it is not yet part of it. Only call this for the host's own
+     * color and for colors that have joined.
+     * \param color the color of the player
+     * \return the world state of the player
+     */
+    PlayerSnapshot& worldPlayer(PlayerColor color);
+
+    /*!
+     * \brief Records a new position for a player in the world. A position reported by a client
+     * is not trusted: one that is not a finite number is dropped, one further away than the
+     * player could have moved since the last update only moves the player as far as it could
+     * have towards it, and one the player could only reach through a wall leaves it where it was.
+     * \param color the color of the player
+     * \param position the new position of the player
+     * \param inputSequence the sequence number of the input that led to this position, or 0 if unknown
+     * \param validate whether or not to check the move
+     * \return the position that was recorded
+     */
+    QPointF updatePlayerPosition(PlayerColor color, QPointF position, quint32 inputSequence, bool validate);
+
+    /*!
+     * \brief Fires a bullet in the simulated world. A bullet fired by a client is not trusted:
+     * it must leave from near the shooter, and the shooter must not fire faster than
+     * BULLET_FIRE_INTERVAL allows.
+     * \param shooter the color of the player firing
+     * \param source the point the bullet is fired from
+     * \param angle the angle the bullet is fired at
+     * \param validate whether or not to check where and how often the shooter fires
+     * \return whether or not the shooter was able to fire, which the dead are not
+     */
+    bool spawnBullet(PlayerColor shooter, QPointF source, qreal angle, bool validate);
+
+    /*!
+     * \brief Replaces the health kits of the simulated world with the map's next wave.
+     */
+    void spawnHealthKitWave();
+
+    /*!
+     * \brief Copies health, crown and death from the simulated world into the snapshot, and
+     * tells every client about each player whose state changed.
+     */
+    void syncPlayerHealth();
+
+    void sendMessageToClients(Message const& message, QAbstractSocket* except = nullptr);
+    void forwardToClients(Message const& message, QAbstractSocket* sender);
+    void broadcastFrames(Message const& message, QByteArray (&frames)[WireFormat::BINARY_FORMAT + 1], QAbstractSocket* except);
 
     QTcpServer* _server;
     QMap<PlayerColor, QAbstractSocket*> _sockets;
@@ -79,8 +303,47 @@ private:
     QMap<QAbstractSocket*, QTimer*> _timeoutTimers;
     QList<QAbstractSocket*> _tempConnected;
 
+    QTimer* _statisticsTimer;
+    qint64 _serializations = 0;
+    qint64 _framesSent = 0;
+    qint64 _lastSerializationsSaved = 0;
+    int _serializationsSavedPerSecond = 0;
+
+    WorldSnapshot _world;
+    MapData _map;
+    GameWorld _gameWorld;
+
+    /*!
+     * \brief Tick clock time (in milliseconds) the world has been stepped up to
+     */
+    qint64 _simulatedTime = 0;
+    qint64 _nextHealthKitWaveAt = 0;
+    int _healthKitWave = 0;
+    QMap<PlayerColor, qint64> _lastPositionTimes;
+
+    /*!
+     * \brief World time (in milliseconds) each player's shots are rate limited up to
+     */
+    QMap<PlayerColor, qint64> _nextShotTimes;
+    QVector<WorldSnapshot> _snapshotHistory;
+    QHash<QAbstractSocket*, quint32> _ackedTicks;
+
+    QTimer* _tickTimer;
+    QElapsedTimer _tickClock;
+    qint64 _lastTickAt = 0;
+    qint64 _tickAccumulator = 0;
+    qint64 _droppedTicks = 0;
+    int _tickRate = SERVER_TICK_RATE;
+    int _sendRate = SERVER_SEND_RATE;
+    int _ticksSinceSend = 0;
+
+    qint64 _lastTickTime = 0;
+    double _averageTickTime = 0.0;
+    qint64 _maxTickTime = 0;
+
     int _maxPlayers = DEFAULT_MAX_PLAYERS;
     bool _hosting = false;
+    bool _dedicated = false;
     bool _hasGameStarted = false;
     QString _username = QStringLiteral("NULL");
     PlayerColor _color;
@@ -15,6 +15,12 @@ enum class PlayerColor
     Gray,
 };
 
+/*!
+ * \brief Stands in for a player where there may not be one, such as the winner of a game
+ * nobody won. No player has this color.
+ */
+const PlayerColor NO_PLAYER = static_cast<PlayerColor>(0xff);
+
 QDataStream& operator<<(QDataStream& ds, PlayerColor const value);
 
 QDataStream& operator>>(QDataStream& ds, PlayerColor& value);
@@ -1,4 +1,5 @@
 #include "playeritem.h"
+#include "texturecache.h"
 
 
 PlayerItem::PlayerItem(PlayerColor color)
@@ -15,33 +16,76 @@ PlayerItem::PlayerItem(PlayerColor color)
 
     // add healthbar
     myHealthbar = new HealthbarItem();
+
+    // be told about moves so the healthbar can follow
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges);
 }
 
 void PlayerItem::reset()
 {
-    this->setPos(respawnPoint);  // reset position of each player to their spawn point
-    this->setHealth(maxHealth);
-    this->setHasCrown(false);   // remove the crown from everyone
+    _input = PlayerInput();
+    _predictions.clear();
+}
+
+void PlayerItem::setLocallyControlled(bool value)
+{
+    _locallyControlled = value;
+    _predictions.clear();
+}
+
+void PlayerItem::recordPrediction(QPointF position)
+{
+    bool hasMoved = _predictions.isEmpty() || _predictions.last().position != position;
+
+    _inputSequence++;
+    if (_predictions.size() >= INPUT_HISTORY_SIZE)
+    {
+        _predictions.removeFirst();
+    }
+    _predictions.append({ _inputSequence, position });
+
+    // Standing still does not need to be sent again
+    if (hasMoved)
+    {
+        emit moved(_color, position, _inputSequence);
+    }
+}
 
-    leftKeyPressed = false;
-    leftKeyReleased = false;
+QPointF PlayerItem::reconcile(quint32 inputSequence, QPointF position)
+{
+    // Forget the predictions the host has already moved past
+    while (!_predictions.isEmpty() && _predictions.first().sequence < inputSequence)
+    {
+        _predictions.removeFirst();
+    }
 
-    rightKeyPressed = false;
-    rightKeyReleased = false;
+    if (_predictions.isEmpty() || _predictions.first().sequence != inputSequence)
+    {
+        return QPointF();
+    }
 
-    upKeyPressed = false;
-    upKeyReleased = false;
+    QPointF error = position - _predictions.first().position;
+    _predictions.removeFirst();
 
-    downKeyPressed = false;
-    downKeyReleased = false;
+    qreal size = qSqrt(QPointF::dotProduct(error, error));
+    if (size < RECONCILIATION_THRESHOLD)
+    {
+        return QPointF();
+    }
 
-    allowedToMove = true;
-    allowedToShoot = true;
+    // Every later prediction started from the wrong position, so move all of them
+    //  (and the player) by the same amount
+    for (PredictedMove& prediction : _predictions)
+    {
+        prediction.position += error;
+    }
 
-    velocityX = 0.0;
-    velocityY = 0.0;
+    _correctionCount++;
+    _lastCorrection = size;
+    _maxCorrection = qMax(_maxCorrection, size);
+    _totalCorrection += size;
 
-    _bullets.clear();
+    return error;
 }
 
 void PlayerItem::setColor(PlayerColor value)
@@ -57,23 +101,19 @@ void PlayerItem::keyPressEvent(QKeyEvent *event)
 {
     // Move Left pressed
     if ( event && (event->key() == Qt::Key_Left || event->key() == Qt::Key_A)) {
-        leftKeyPressed = true;
-        leftKeyReleased = false;
+        _input.left = true;
     }
     // Move Right pressed
     if (event && (event->key() == Qt::Key_Right || event->key() == Qt::Key_D)) {
-        rightKeyPressed = true;
-        rightKeyReleased = false;
+        _input.right = true;
     }
     // Move Up pressed
     if (event && (event->key() == Qt::Key_Up || event->key() == Qt::Key_W)) {
-        upKeyPressed = true;
-        upKeyReleased = false;
+        _input.up = true;
     }
     // Move Down pressed
     if (event && (event->key() == Qt::Key_Down || event->key() == Qt::Key_S)) {
-        downKeyPressed = true;
-        downKeyReleased = false;
+        _input.down = true;
     }
     QGraphicsItem::keyPressEvent(event);
 }
@@ -82,59 +122,33 @@ void PlayerItem::keyReleaseEvent(QKeyEvent *event)
 {
     // Move Left released
     if ( event && (event->key() == Qt::Key_Left || event->key() == Qt::Key_A)) {
-        leftKeyReleased = true;
-        leftKeyPressed = false;
+        _input.left = false;
     }
     // Move Right released
     if (event && (event->key() == Qt::Key_Right || event->key() == Qt::Key_D)) {
-        rightKeyReleased = true;
-        rightKeyPressed = false;
+        _input.right = false;
     }
     // Move Up released
     if (event && (event->key() == Qt::Key_Up || event->key() == Qt::Key_W)) {
-        upKeyReleased = true;
-        upKeyPressed = false;
+        _input.up = false;
     }
     // Move Down released
     if (event && (event->key() == Qt::Key_Down || event->key() == Qt::Key_S)) {
-        downKeyReleased = true;
-        downKeyPressed = false;
+        _input.down = false;
     }
     QGraphicsItem::keyReleaseEvent(event);
 }
 
 void PlayerItem::shoot(QPointF attackDestination)
 {
-    if (allowedToShoot)
+    if (!_isDead)
     {
         // create a line between player and where mouse was clicked
         QLineF ln(QPointF(this->x() + width/qreal(2), this->y() + height/qreal(2)), attackDestination);
         // find angle of line, multiply by -1 because Qt does angles CW instead of CCW
         qreal angle = ln.angle() * qreal(-1);
 
-        this->shoot(QPointF(scenePos().x() + width/qreal(2), scenePos().y() + height/qreal(2)), angle);
-    }
-}
-
-void PlayerItem::shoot(QPointF source, qreal angle, bool fromNetwork)
-{
-    // create a bullet
-    BulletItem* bullet = new BulletItem(this);
-    // set bullet start position to middle of player
-    bullet->setPos(source);
-    bullet->setRotation(angle); // rotate the bullet to match angle that it's fired
-
-    connect(bullet, &BulletItem::collided,
-            [=]
-            {
-                _bullets.removeOne(bullet);
-            });
-    _bullets.append(bullet);
-    scene()->addItem(bullet); // add bullet to the scene
-
-    if (!fromNetwork)
-    {
-        emit shotBullet(_color, source, angle);
+        emit shotBullet(_color, QPointF(scenePos().x() + width/qreal(2), scenePos().y() + height/qreal(2)), angle);
     }
 }
 
@@ -151,455 +165,132 @@ void PlayerItem::setHasCrown(bool value)
     {
     case PlayerColor::Red:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-red.png" : ":/images/player-red.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-red.png" : ":/images/player-red.png");
         break;
     case PlayerColor::Blue:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-blue.png" : ":/images/player-blue.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-blue.png" : ":/images/player-blue.png");
         break;
     case PlayerColor::Green:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-green.png" : ":/images/player-green.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-green.png" : ":/images/player-green.png");
         break;
     case PlayerColor::Magenta:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-magenta.png" : ":/images/player-magenta.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-magenta.png" : ":/images/player-magenta.png");
         break;
     case PlayerColor::White:
         this->setPen(QPen(Qt::white, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-white.png" : ":/images/player-white.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-white.png" : ":/images/player-white.png");
         break;
     case PlayerColor::Black:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-black.png" : ":/images/player-black.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-black.png" : ":/images/player-black.png");
         break;
     case PlayerColor::Cyan:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-cyan.png" : ":/images/player-cyan.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-cyan.png" : ":/images/player-cyan.png");
         break;
     case PlayerColor::Gray:
         this->setPen(QPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
-        playerBrush.setTextureImage(QImage(value ? ":/images/playerwithcrown-gray.png" : ":/images/player-gray.png"));
+        playerSprite = TextureCache::instance().pixmap(value ? ":/images/playerwithcrown-gray.png" : ":/images/player-gray.png");
         break;
     }
-    this->setBrush(playerBrush);
+    update();
 
     emit hasCrownChanged(value);
 }
 
-void PlayerItem::advance(int phase)
+QRectF PlayerItem::boundingRect() const
 {
-    if (phase == 0)
-        return;
-
-    /***Controls Left & Right movement***/
-    // Move Right
-    if (rightKeyPressed) {
-        velocityX += acceleration;
-        if (velocityX > max_speed) {
-            velocityX = max_speed;
-        }
-    }
-    // Move Left
-    else if (leftKeyPressed) {
-        velocityX -= acceleration;
-        if (velocityX < -max_speed) {
-            velocityX = -max_speed;
-        }
-    }
-    // Slow down x-axis
-    else if (rightKeyReleased || leftKeyReleased) {
-        if (velocityX < 0) {
-            velocityX += acceleration;
-            if (velocityX >= 0) {
-                velocityX = 0;
-            }
-        }
-        else {
-            velocityX -= acceleration;
-            if (velocityX <= 0) {
-                velocityX = 0;
-            }
-        }
-    }
-
-    /***Controls Up & Down movement***/
-    // Move Down
-    if (downKeyPressed) {
-        velocityY += acceleration;
-        if (velocityY > max_speed) {
-            velocityY = max_speed;
-        }
-    }
-    // Move Up
-    else if (upKeyPressed) {
-        velocityY -= acceleration;
-        if (velocityY < -max_speed) {
-            velocityY = -max_speed;
-        }
-    }
-    // Slow down y-axis
-    else if (downKeyReleased || upKeyReleased) {
-        if (velocityY < 0) {
-            velocityY += acceleration;
-            if (velocityY >= 0) {
-                velocityY = 0;
-            }
-        }
-        else {
-            velocityY -= acceleration;
-            if (velocityY <= 0) {
-                velocityY = 0;
-            }
-        }
-    }
-    // set current position as "previousPos" to use in case of collision with wall or player
-    previousPos = (this->scenePos());
-    // set new position of player/healthbar/visible health
-    myHealthbar->setPos(this->x()-12.5 + velocityX, this->y()-10 + velocityY);
-    myHealthbar->visibleHealth->setPos(this->x()-12.5 + velocityX, this->y()-10 + velocityY);
-    if (allowedToMove){
-        setX(this->x() + velocityX);
-        setY(this->y() + velocityY);
-    }
-
-    // if collision with wall, bounce off wall
-    if (this->collidesWithWall()){
-        // Need to check if we are moving at a diagonal
-        if((velocityX != 0.0) && (velocityY != 0.0)) {
-            // Check each viable direction for collision
-            // Moving against a vertical surface
-            setPos(this->previousPos);  // Reset pos to when we were not colliding
-            setX(this->x());            // Leave X, change Y
-            setY(this->y() + velocityY);
-
-            if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-            // Moving against a horizontal surface
-            setPos(this->previousPos);   // Reset pos to when we were not colliding
-            setX(this->x() + velocityX); // Change X, leave Y
-            setY(this->y());
-
-            if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-            // If we're trying to go across a diagonal wall, reset position and try for diagonals
-            setPos(this->previousPos);
-
-            if (leftKeyPressed && upKeyPressed){
-                // if moving across top wall to the left, deal with diagonal
-                if (this->y() < MAP_HEIGHT/2){
-                    setX(this->x() + velocityX);
-                    setY(this->y() - velocityY);
-
-                    if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                        myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                        myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                        return;     // Player position has been updated accordingly
-                    }
-                }
-                else if (this->y() > MAP_HEIGHT/2){
-                    // if still colliding, reset pos and deal with moving up the left wall
-                    setPos(this->previousPos);
-
-                    setX(this->x() - velocityX);
-                    setY(this->y() + velocityY);
-
-                    if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                        myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                        myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                        return;     // Player position has been updated accordingly
-                    }
-                }
-            }
-
-            if (leftKeyPressed && downKeyPressed){
-                // If this case comes before the next one the wall across the top is a problem but the side wall is fine
-                // If this case comes after the next one the side wall is a problem but the top wall is fine
-                setX(this->previousPos.x() - velocityX);    // Set X to negated altered velocity
-                setY(this->previousPos.y() + velocityY);    // Set Y to altered velocity
-
-                if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                    myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    return;     // Player position has been updated accordingly
-                }
-
-                // The case below is the one refered to by the comments above
-                setX(this->previousPos.x() + velocityX);    // Set X to altered velocity
-                setY(this->previousPos.y() - velocityY);    // Set Y to negated altered velocity
-
-                if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                    myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    return;     // Player position has been updated accordingly
-                }
-            }
-
-            if ((rightKeyPressed && upKeyPressed) || (rightKeyPressed && downKeyPressed)){
-                // If this case comes before the next one the wall across the top is a problem but the side wall is fine
-                // If this case comes after the next one the side wall is a problem but the top wall is fine
-                setX(this->previousPos.x() + velocityX);    // Set X to negated altered velocity
-                setY(this->previousPos.y() - velocityY);    // Set Y to altered velocity
-
-                if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                    myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    return;     // Player position has been updated accordingly
-                }
-
-                // The case below is the one refered to by the comments above
-                setX(this->previousPos.x() - velocityX);    // Set X to altered velocity
-                setY(this->previousPos.y() + velocityY);    // Set Y to negated altered velocity
-
-                if(!(this->collidesWithWall())) {   // Not colliding with a wall
-                    myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                    return;     // Player position has been updated accordingly
-                }
-            }
-
-            //            // This case doesn't really do anything other than fix a glitch where you can escape the map
-            //            setX(this->previousPos.x() - velocityX);    // Set X to negated altered velocity
-            //            setY(this->previousPos.y() - velocityY);     // Set Y to negated altered velocity
-
-            //            if(!(this->collidesWithWall())) {   // Not colliding with a wall
-            //                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            //                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            //                return;     // Player position has been updated accordingly
-            //            }
-
-            // set new position of player/healthbar/visible health if none of the above positions work
-            myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            setPos(this->previousPos);
-            velocityX *= -0.75;
-            velocityY *= -0.75;
-        }
-        else {  // not moving diagonally
-            // set new position of player/healthbar/visible health
-            myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            setPos(this->previousPos);
-            velocityX *= -0.75;
-            velocityY *= -0.75;
-        }
-
-    }
-    // if collision with player, bounce off other player
-    // Want to add imparting a backwards velocity on other player
-    if (this->collidesWithPlayer()){
-        // Need to check if we are moving at a diagonal
-        if((velocityX != 0.0) && (velocityY != 0.0)) {
-            // Check each viable direction for collision
-            // Moving against a vertical surface
-            setPos(this->previousPos);  // Reset pos to when we were not colliding
-            setX(this->x());            // Leave X, change Y
-            setY(this->y() + velocityY);
-
-            if(!(this->collidesWithPlayer())) {   // Not colliding with a Player
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-            // Moving against a horizontal surface
-            setPos(this->previousPos);   // Reset pos to when we were not colliding
-            setX(this->x() + velocityX); // Change X, leave Y
-            setY(this->y());
-
-            if(!(this->collidesWithPlayer())) {   // Not colliding with a Player
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-            // If we're trying to go across a diagonal wall, reset position and try for diagonals
-            setPos(this->previousPos);
-
-
-            // If this case comes before the next one the wall across the top is a problem but the side wall is fine
-            // If this case comes after the next one the side wall is a problem but the top wall is fine
-            setX(this->previousPos.x() + velocityX);    // Set X to negated altered velocity
-            setY(this->previousPos.y() - velocityY);    // Set Y to altered velocity
-
-            if(!(this->collidesWithPlayer())) {   // Not colliding with a Player
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-
-            // The case below is the one refered to by the comments above
-            setX(this->previousPos.x() - velocityX);    // Set X to altered velocity
-            setY(this->previousPos.y() + velocityY);    // Set Y to negated altered velocity
-
-            if(!(this->collidesWithPlayer())) {   // Not colliding with a Player
-                myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-                return;     // Player position has been updated accordingly
-            }
-
-            // set new position of player/healthbar/visible health if none of the above positions work
-            myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            setPos(this->previousPos);
-            velocityX *= -0.75;
-            velocityY *= -0.75;
-        }
-        else {  // not moving diagonally
-            // set new position of player/healthbar/visible health
-            myHealthbar->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            myHealthbar->visibleHealth->setPos(this->previousPos.x()-12.5, this->previousPos.y()-10);
-            setPos(this->previousPos);
-            velocityX *= -0.75;
-            velocityY *= -0.75;
-        }
-    }
-    // if collision with health, player regains health
-    if (this->collidesWithHealth()){
-        // picking up a health kit regains health to max
-        for (int i = 1; i < maxHealth; i++){
-            gainHealth();
-        }
-    }
-}   // end of advance
+    // Leave room for the render offset, which is never more than one frame's movement
+    return QGraphicsEllipseItem::boundingRect().adjusted(-PLAYER_MAX_VELOCITY, -PLAYER_MAX_VELOCITY,
+                                                         PLAYER_MAX_VELOCITY, PLAYER_MAX_VELOCITY);
+}
 
-bool PlayerItem::collidesWithWall()
+void PlayerItem::paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget* widget)
 {
-    QList<QGraphicsItem*> collidingItems = this->collidingItems();
-
-    foreach (QGraphicsItem * item, collidingItems){
-        WallItem * wall = dynamic_cast<WallItem*>(item);
-        if (wall){
-            return true;
-        }
-    }
-    return false;
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // Blit the sprite and stroke the outline, rather than filling the ellipse with a texture
+    painter->translate(_renderOffset);
+    painter->drawPixmap(rect().topLeft(), playerSprite);
+    painter->setPen(pen());
+    painter->setBrush(Qt::NoBrush);
+    painter->drawEllipse(rect());
 }
 
-bool PlayerItem::collidesWithPlayer()
+void PlayerItem::setRenderOffset(QPointF offset)
 {
-    QList<QGraphicsItem*> collidingItems = this->collidingItems();
+    // Teleports (dying, respawning, corrections) are drawn as-is
+    if (qAbs(offset.x()) > PLAYER_MAX_VELOCITY || qAbs(offset.y()) > PLAYER_MAX_VELOCITY)
+    {
+        offset = QPointF();
+    }
 
-    foreach (QGraphicsItem * item, collidingItems)
+    if (offset != _renderOffset)
     {
-        // If two players collide
-        if (PlayerItem* player = dynamic_cast<PlayerItem*>(item))
-        {
-            // If either player has the crown
-            if (this->hasCrown())
-            {
-                // Swap the crown between the two colliding players
-                this->setHasCrown(false);
-                player->setHasCrown(true);
-            }
-            else if (player->hasCrown())
-            {
-                // Swap the crown between the two colliding players
-                this->setHasCrown(true);
-                player->setHasCrown(false);
-            }
-            return true;
-        }
+        _renderOffset = offset;
+        updateHealthbar();
+        update();
     }
-    return false;
 }
 
-bool PlayerItem::collidesWithHealth()
+QVariant PlayerItem::itemChange(GraphicsItemChange change, QVariant const& value)
 {
-    QList<QGraphicsItem*> collidingItems = this->collidingItems();
-
-    foreach (QGraphicsItem * item, collidingItems)
+    if (change == QGraphicsItem::ItemPositionHasChanged)
     {
-        HealthItem * healthKit = dynamic_cast<HealthItem*>(item);
-        if (healthKit)
-        {
-            healthKit->scene()->removeItem(healthKit);
-            return true;
-        }
+        updateHealthbar();
     }
 
-    return false;
+    return QGraphicsEllipseItem::itemChange(change, value);
 }
 
-void PlayerItem::die()
+void PlayerItem::updateHealthbar()
 {
-    //qDebug() << "player has died";
-    this->allowedToShoot = false; // don't allow player to shoot when dead
-    this->allowedToMove = false; // don't allow player to move when dead
-    this->hide(); // hide player when dead
-    this->setPos(-100, -100); // set player off map when dead to avoid unwanted collisions
-    this->myHealthbar->hide(); // hide healthbar when dead
-    this->myHealthbar->visibleHealth->hide(); // hide visible health when dead
-
-    this->isDead = true;
-    // connect 5 second timer that will activate between player death and respawn
-    deathTimer.singleShot(PLAYER_RESPAWN_TIME, this, SLOT(respawn()));
-}
+    QPointF position = this->pos() + _renderOffset + QPointF(-12.5, -10);
 
-void PlayerItem::respawn()
-{
-    this->isDead = false;
-    //qDebug() << "player has respawned";
-    this->allowedToShoot = true; // player allowed to shoot when respawns
-    this->allowedToMove = true; // player allowed to move when respawns
-    this->_health = this->maxHealth; // set health to max upon respawn
-    this->setPos(respawnPoint); // set player at their respawn point
-    this->show(); // show the player
-    this->myHealthbar->show(); // show the healthbar
-    this->myHealthbar->vhWidth = this->myHealthbar->vhMaxWidth; // reset visible health to max
-    this->myHealthbar->visibleHealth->show(); // show visible health
-
-    // if on respawn, player is colliding with another player, move player out of collision
-    // to prevent player freezing
-    if (collidesWithPlayer()){
-        this->setY(this->y() - height*2);
-    }
-    return;
+    myHealthbar->setPos(position);
+    myHealthbar->visibleHealth->setPos(position);
 }
 
-void PlayerItem::reduceHealth()
+void PlayerItem::setDead(bool value, qint64 time)
 {
-    // set amount of pixels the healthbar goes down when taking damage
-    double healthInPixels = (myHealthbar->vhMaxWidth)/(this->maxHealth);
-    // if player takes damage, reduce health
-    _health--;
-    myHealthbar->vhWidth -= healthInPixels; // set visible health according to damage
-    this->myHealthbar->visibleHealth->setRect(0,0,myHealthbar->vhWidth, myHealthbar->vhHeight);
-    // if player's health reaches zero, they die
-    if (_health <= 0)
+    if (value == _isDead)
     {
-        die();
+        return;
     }
-}
 
-void PlayerItem::gainHealth()
-{
-    // set amount of pixels the healthbar goes up when gaining health
-    double healthInPixels = (myHealthbar->vhMaxWidth)/(this->maxHealth);
-    // player gains health
-    _health++;
-    myHealthbar->vhWidth += healthInPixels; // set visible health according to health gain
-    this->myHealthbar->visibleHealth->setRect(0,0,myHealthbar->vhWidth, myHealthbar->vhHeight);
-    if (_health >= maxHealth)
+    _isDead = value;
+    _predictions.clear(); // moving off or back onto the map is not a predicted move
+
+    // hide the player and its healthbar while dead
+    this->setVisible(!value);
+    myHealthbar->setVisible(!value);
+    myHealthbar->visibleHealth->setVisible(!value);
+
+    if (value)
+    {
+        emit died(_color, time);
+    }
+    else
     {
-        _health = maxHealth;
-        this->myHealthbar->vhWidth = myHealthbar->vhMaxWidth;
+        emit respawned(_color, time);
     }
 }
 
 void PlayerItem::setHealth(int value)
 {
-    while (_health < value)
+    value = qBound(0, value, PLAYER_MAX_HEALTH);
+    if (value == _health)
     {
-        gainHealth();
+        return;
     }
 
-    while (_health > value)
-    {
-        reduceHealth();
-    }
+    _health = value;
+
+    // set visible health according to the remaining health
+    myHealthbar->vhWidth = myHealthbar->vhMaxWidth * _health / PLAYER_MAX_HEALTH;
+    myHealthbar->visibleHealth->setRect(0, 0, myHealthbar->vhWidth, myHealthbar->vhHeight);
 }
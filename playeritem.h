@@ -1,13 +1,10 @@
 #ifndef PLAYERITEM_H
 #define PLAYERITEM_H
 
-#include "wallitem.h"
 #include "healthbaritem.h"
-#include "bulletitem.h"
-#include "healthitem.h"
 #include "settings.h"
-#include "respawnoverlayitem.h"
 #include "playercolor.h"
+#include "gameworld.h"
 
 #include <QKeyEvent>
 #include <QMouseEvent>
@@ -21,7 +18,8 @@
 #include <QString>
 #include <QPointF>
 /*!
- * \brief PlayerItem class controls player creation, movement, shooting, death, respawn and map interactions
+ * \brief PlayerItem class draws a player and its healthbar, and collects the local user's input.
+ * The player's movement, health and crown are decided by the GameWorld and mirrored here.
  */
 class PlayerItem : public QObject, public QGraphicsEllipseItem
 {
@@ -47,16 +45,15 @@ public:
      */
     void setColor(PlayerColor value);
 
-    inline BulletItem const* const* bullets() const
+    /*!
+     * \brief Gets the movement keys the user is holding down for this player
+     * \return the held movement keys
+     */
+    inline PlayerInput input() const
     {
-        return _bullets.data();
+        return _input;
     }
 
-    /*!
-     * \brief Sets the player starting health
-     */
-    int maxHealth = PLAYER_MAX_HEALTH;
-    int _health = PLAYER_MAX_HEALTH;
     /*!
      * \brief Handles keyPressEvents for the playeritem
      */
@@ -66,36 +63,34 @@ public:
      */
     void keyReleaseEvent(QKeyEvent * event) override;
     /*!
-     * \brief Variable that holds the respawn point for the player
+     * \brief Image of the player, drawn inside its outline
      */
-    QPointF respawnPoint;
-    /*!
-     * \brief Brush to paint player images
-     */
-    QBrush playerBrush;
+    QPixmap playerSprite;
     /*!
      * \brief Players healthbar
      */
     HealthbarItem* myHealthbar;
     /*!
-     * \brief Shoots a bullet from the player's current location
-     * to the specified attack location.
+     * \brief Requests a bullet from the player's current location
+     * to the specified attack location. Dead players cannot shoot.
      * \param the scene position at which to aim and shoot
      */
     void shoot(QPointF attackDestination);
-    void shoot(QPointF source, qreal angle, bool fromNetwork = false);
-    /*!
-     * \brief Function to reduce the health of the player
-     */
-    void reduceHealth();
     /*!
-     * \brief Function to increase the health of the player
+     * \brief Function to determine if the player is dead
+     * \return true or false
      */
-    void gainHealth();
+    inline bool isDead() const
+    {
+        return _isDead;
+    }
     /*!
-     * \brief Variable that says if the player is dead or not
+     * \brief Hides the player and its healthbar while dead, and shows them again once alive.
+     * Emits died or respawned when the value changes.
+     * \param true or false
+     * \param time the world time (in milliseconds) the player died or respawned at
      */
-    bool isDead = false;
+    void setDead(bool value, qint64 time);
     /*!
      * \brief Function to determine if the player has the crown
      * \return returns variable _hascrown which is a boolean of if the player has the crown or not
@@ -123,20 +118,111 @@ public:
      */
     void setHealth(int value);
 
+    /*!
+     * \brief Releases every movement key and forgets every prediction, for the start of a new game
+     */
     void reset();
 
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget* widget = nullptr) override;
+
+    /*!
+     * \brief Draws the player (and its healthbar) the specified distance away from its simulated
+     * position, so that movement between advance frames looks smooth regardless of the frame rate.
+     * Offsets larger than one frame's movement, such as teleports, are not drawn.
+     * \param offset the distance from the simulated position to draw at
+     */
+    void setRenderOffset(QPointF offset);
+
+    /*!
+     * \brief Returns whether this player is controlled by the local user, in which case its
+     * movement is predicted immediately and later reconciled with the host.
+     * \return true or false
+     */
+    inline bool isLocallyControlled() const
+    {
+        return _locallyControlled;
+    }
+    /*!
+     * \brief Sets whether this player is controlled by the local user
+     * \param true or false
+     */
+    void setLocallyControlled(bool value);
+    /*!
+     * \brief Remembers the position predicted by an advance frame and announces it
+     * \param position the predicted position of the player
+     */
+    void recordPrediction(QPointF position);
+    /*!
+     * \brief Corrects the predicted position of the player once the host has processed its
+     * inputs up to the specified sequence number. Every prediction made since then is moved
+     * by the same amount the acknowledged prediction was off by.
+     * \param inputSequence the sequence number of the last input the host has applied
+     * \param position the authoritative position of the player after that input
+     * \return how far the player has to be moved, or a null point if no correction is needed
+     */
+    QPointF reconcile(quint32 inputSequence, QPointF position);
+    /*!
+     * \brief Gets the number of corrections applied to the predicted position so far
+     * \return the number of corrections
+     */
+    inline int correctionCount() const
+    {
+        return _correctionCount;
+    }
+    /*!
+     * \brief Gets the size (in pixels) of the last correction
+     * \return the size of the last correction
+     */
+    inline qreal lastCorrection() const
+    {
+        return _lastCorrection;
+    }
+    /*!
+     * \brief Gets the size (in pixels) of the largest correction so far
+     * \return the size of the largest correction
+     */
+    inline qreal maxCorrection() const
+    {
+        return _maxCorrection;
+    }
+    /*!
+     * \brief Gets the average size (in pixels) of the corrections so far
+     * \return the average size of a correction
+     */
+    inline qreal averageCorrection() const
+    {
+        return _correctionCount > 0 ? _totalCorrection / _correctionCount : 0.0;
+    }
+
 signals:
     void shotBullet(PlayerColor color, QPointF source, qreal angle);
     void hasCrownChanged(bool newValue);
-
-public slots:
     /*!
-     * \brief Function for when player respawns
+     * \brief Emitted when the locally controlled player has moved during an advance frame
+     * \param color the color of the player
+     * \param position the predicted position of the player
+     * \param inputSequence the sequence number of the advance frame's input
+     */
+    void moved(PlayerColor color, QPointF position, quint32 inputSequence);
+    /*!
+     * \brief Emitted when the player dies
+     * \param color the color of the player
+     * \param time the world time (in milliseconds) the player died at
+     */
+    void died(PlayerColor color, qint64 time);
+    /*!
+     * \brief Emitted when the player comes back to life
+     * \param color the color of the player
+     * \param time the world time (in milliseconds) the player respawned at
      */
-    void respawn();
+    void respawned(PlayerColor color, qint64 time);
 
 protected:
-    void advance(int phase) override;
+    /*!
+     * \brief Keeps the healthbar above the player as it moves
+     */
+    QVariant itemChange(GraphicsItemChange change, QVariant const& value) override;
 
 private:
     /*!
@@ -146,68 +232,56 @@ private:
     /*!
      * \brief Variable that stores width of player ellipse
      */
-    qreal width = 25;
+    qreal width = PLAYER_SIZE;
     /*!
      * \brief Variable that stores height of player ellipse
      */
-    qreal height = 25;
+    qreal height = PLAYER_SIZE;
 
-    QVector<BulletItem*> _bullets;
-
-    // speed/acceleration variables
-    double velocityX = 0.0,
-        velocityY = 0.0,
-        acceleration = PLAYER_ACCELERATION,
-        max_speed = PLAYER_MAX_VELOCITY;
-    /*!
-     * \brief Variable for if the player has the crown. On player creation initialized to false
-     */
-    bool _hasCrown = false;
     /*!
-     * \brief Variable to control if the player is allowed to move. Set to false when dead
+     * \brief A position predicted for the local player, and the input that led to it
      */
-    bool allowedToMove = true;
+    struct PredictedMove
+    {
+        quint32 sequence;
+        QPointF position;
+    };
     /*!
-     * \brief Variable to control is the player is allowed to shoot. Set to false when dead
+     * \brief Variable for if the player is controlled by the local user
      */
-    bool allowedToShoot = true;
-    // bool values for key press
-    bool leftKeyPressed=false,
-        rightKeyPressed=false,
-        upKeyPressed=false,
-        downKeyPressed=false;
-    // bool values for key releases
-    bool leftKeyReleased=true,
-        rightKeyReleased=true,
-        upKeyReleased=true,
-        downKeyReleased=true;
+    bool _locallyControlled = false;
     /*!
-     * \brief Function to determine if the player is colliding with a wall
-     * \return true or false
+     * \brief Sequence number of the last recorded input
      */
-    bool collidesWithWall();
+    quint32 _inputSequence = 0;
     /*!
-     * \brief Function to determine if the player is colliding with another player
-     * \return true or false
+     * \brief Predicted moves that the host has not acknowledged yet, oldest first
      */
-    bool collidesWithPlayer();
+    QVector<PredictedMove> _predictions;
+
+    int _correctionCount = 0;
+    qreal _lastCorrection = 0.0;
+    qreal _maxCorrection = 0.0;
+    qreal _totalCorrection = 0.0;
+
     /*!
-     * \brief Function to determine if the player is colliding with a health item
-     * \return true or false
+     * \brief Variable for if the player has the crown. On player creation initialized to false
      */
-    bool collidesWithHealth();
+    bool _hasCrown = false;
+    bool _isDead = false;
+    int _health = PLAYER_MAX_HEALTH;
     /*!
-     * \brief Variable to store previous position for help in collision detection
+     * \brief Movement keys currently held down
      */
-    QPointF previousPos;
+    PlayerInput _input;
     /*!
-     * \brief Timer for death countdown
+     * \brief Offset from the simulated position at which the player is drawn
      */
-    QTimer deathTimer;
+    QPointF _renderOffset;
     /*!
-     * \brief Function for when player dies
+     * \brief Moves the healthbar to sit above where the player is drawn
      */
-    void die();
+    void updateHealthbar();
 };
 
 #endif // PLAYERITEM_H
@@ -0,0 +1,57 @@
+#include "processusage.h"
+
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+qint64 cpuTime()
+{
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+                + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    }
+#endif
+    return -1;
+}
+
+qint64 residentKiB()
+{
+    // The second field of statm is the resident set, in pages
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly))
+    {
+        QList<QByteArray> const fields = statm.readAll().split(' ');
+        bool ok = false;
+        qint64 pages = fields.value(1).toLongLong(&ok);
+#ifdef Q_OS_UNIX
+        if (ok)
+        {
+            return pages * sysconf(_SC_PAGESIZE) / 1024;
+        }
+#endif
+    }
+
+    return -1;
+}
+
+qint64 peakResidentKiB()
+{
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return -1;
+}
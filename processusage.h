@@ -0,0 +1,24 @@
+#ifndef PROCESSUSAGE_H
+#define PROCESSUSAGE_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Returns the CPU time the process has used on every thread, in milliseconds,
+ * or -1 where it cannot be measured.
+ */
+qint64 cpuTime();
+
+/*!
+ * \brief Returns the memory the process has resident right now, in KiB, or -1 where it
+ * cannot be measured.
+ */
+qint64 residentKiB();
+
+/*!
+ * \brief Returns the most memory the process has had resident at once, in KiB, or -1 where
+ * it cannot be measured.
+ */
+qint64 peakResidentKiB();
+
+#endif // PROCESSUSAGE_H
@@ -0,0 +1,86 @@
+#include "projectilesystem.h"
+
+ProjectileSystem::ProjectileSystem(int capacity)
+{
+    _positions.reserve(capacity);
+    _directions.reserve(capacity);
+    _angles.reserve(capacity);
+    _shooters.reserve(capacity);
+    _ages.reserve(capacity);
+    _ids.reserve(capacity);
+    _alive.reserve(capacity);
+    _freeSlots.reserve(capacity);
+}
+
+quint32 ProjectileSystem::spawn(PlayerColor shooter, QPointF source, qreal angle)
+{
+    qreal radians = qDegreesToRadians(angle);
+    QPointF direction(qCos(radians), qSin(radians));
+    quint32 id = _nextId++;
+
+    if (_freeSlots.isEmpty())
+    {
+        _positions.append(source);
+        _directions.append(direction);
+        _angles.append(angle);
+        _shooters.append(shooter);
+        _ages.append(0);
+        _ids.append(id);
+        _alive.append(true);
+    }
+    else
+    {
+        // Reuse the most recently freed slot, which is the most likely to still be in cache
+        int slot = _freeSlots.takeLast();
+        _positions[slot] = source;
+        _directions[slot] = direction;
+        _angles[slot] = angle;
+        _shooters[slot] = shooter;
+        _ages[slot] = 0;
+        _ids[slot] = id;
+        _alive[slot] = true;
+    }
+
+    _liveCount++;
+    return id;
+}
+
+void ProjectileSystem::remove(int slot)
+{
+    if (!_alive[slot])
+    {
+        return;
+    }
+
+    _alive[slot] = false;
+    _freeSlots.append(slot);
+    _liveCount--;
+}
+
+void ProjectileSystem::clear()
+{
+    // Keep the slots allocated for the next game
+    _freeSlots.clear();
+    for (int slot = _alive.size() - 1; slot >= 0; slot--)
+    {
+        _alive[slot] = false;
+        _freeSlots.append(slot);
+    }
+
+    _liveCount = 0;
+}
+
+void ProjectileSystem::advance(qreal distance, qint64 elapsed)
+{
+    int count = _alive.size();
+    QPointF* positions = _positions.data();
+    QPointF const* directions = _directions.constData();
+    qint64* ages = _ages.data();
+
+    // Moving a free slot is harmless, and cheaper than checking for it
+    for (int slot = 0; slot < count; slot++)
+    {
+        positions[slot] += directions[slot] * distance;
+        ages[slot] += elapsed;
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef PROJECTILESYSTEM_H
+#define PROJECTILESYSTEM_H
+
+#include "playercolor.h"
+#include "settings.h"
+
+#include <QPointF>
+#include <QVector>
+
+/*!
+ * \brief The ProjectileSystem class holds every bullet in flight. Each property of the bullets
+ * is kept in its own array, indexed by slot, so that advancing every bullet is one tight pass
+ * over contiguous memory. The slots of removed bullets go on a free list and are reused by the
+ * next bullets fired, so sustained fire does not allocate.
+ */
+class ProjectileSystem
+{
+public:
+    /*!
+     * \brief Creates an empty system.
+     * \param capacity the number of slots to allocate up front
+     */
+    explicit ProjectileSystem(int capacity = PROJECTILE_INITIAL_CAPACITY);
+
+    /*!
+     * \brief Fires a bullet.
+     * \param shooter the color of the player who fired the bullet
+     * \param source the position of the rear end of the bullet
+     * \param angle the angle at which the bullet travels (0 degrees = horizontal, facing right)
+     * \return the id of the new bullet, which unlike its slot is never reused
+     */
+    quint32 spawn(PlayerColor shooter, QPointF source, qreal angle);
+
+    /*!
+     * \brief Removes the bullet in a slot, freeing the slot for the next bullet fired.
+     * \param slot the slot of the bullet
+     */
+    void remove(int slot);
+
+    /*!
+     * \brief Removes every bullet.
+     */
+    void clear();
+
+    /*!
+     * \brief Moves every bullet forward along its direction.
+     * \param distance how far to move each bullet, in pixels
+     * \param elapsed how much time the move takes, in milliseconds
+     */
+    void advance(qreal distance, qint64 elapsed);
+
+    /*!
+     * \brief Returns the number of slots, alive or not. Slots range from 0 to capacity() - 1.
+     */
+    inline int capacity() const
+    {
+        return _alive.size();
+    }
+
+    /*!
+     * \brief Returns the number of bullets in flight.
+     */
+    inline int size() const
+    {
+        return _liveCount;
+    }
+
+    inline bool isAlive(int slot) const
+    {
+        return _alive[slot];
+    }
+
+    inline quint32 id(int slot) const
+    {
+        return _ids[slot];
+    }
+
+    inline PlayerColor shooter(int slot) const
+    {
+        return _shooters[slot];
+    }
+
+    /*!
+     * \brief Returns the position of the rear end of a bullet. The bullet extends BULLET_LENGTH
+     * pixels from here along its direction.
+     */
+    inline QPointF position(int slot) const
+    {
+        return _positions[slot];
+    }
+
+    /*!
+     * \brief Returns the unit vector a bullet travels along.
+     */
+    inline QPointF direction(int slot) const
+    {
+        return _directions[slot];
+    }
+
+    inline qreal angle(int slot) const
+    {
+        return _angles[slot];
+    }
+
+    /*!
+     * \brief Returns how long (in milliseconds) a bullet has been flying.
+     */
+    inline qint64 age(int slot) const
+    {
+        return _ages[slot];
+    }
+
+private:
+    QVector<QPointF> _positions;
+    QVector<QPointF> _directions;
+    QVector<qreal> _angles;
+    QVector<PlayerColor> _shooters;
+    QVector<qint64> _ages;
+    QVector<quint32> _ids;
+    QVector<bool> _alive;
+
+    /*!
+     * \brief Slots of removed bullets, most recently freed last
+     */
+    QVector<int> _freeSlots;
+
+    int _liveCount = 0;
+    quint32 _nextId = 1;
+};
+
+#endif // PROJECTILESYSTEM_H
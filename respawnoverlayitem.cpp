@@ -1,42 +1,53 @@
 #include "respawnoverlayitem.h"
+#include "settings.h"
+#include "texturecache.h"
 
-#include <QTimer>
 #include <QDebug>
 
-RespawnOverlayItem::RespawnOverlayItem()
+RespawnOverlayItem::RespawnOverlayItem(AnimationClock* clock) :
+    _clock(clock)
 {
-    x = 0;
-    y = 0;
-    w = 1200;
-    h = 600;
     respawnindex = -1;
 
-    images[0] = QImage(":/images/respawnOverlay-1.png");
-    images[1] = QImage(":/images/respawnOverlay-2.png");
-    images[2] = QImage(":/images/respawnOverlay-3.png");
-    images[3] = QImage(":/images/respawnOverlay-4.png");
-    images[4] = QImage(":/images/respawnOverlay-5.png");
-    images[5] = QImage(":/images/respawnOverlay-blank.png");
+    TextureCache& textures = TextureCache::instance();
+    for (int i = 0; i < 5; i++)
+    {
+        frames[i] = textures.trimmedPixmap(QString(":/images/respawnOverlay-%1.png").arg(i + 1), offsets[i]);
+    }
+    frames[5] = textures.trimmedPixmap(":/images/respawnOverlay-blank.png", offsets[5]);
 
-    setRect(x,y,w,h);
-    this->mapToScene(0,0);
+    // hit-testing the overlay does not need its alpha mask
+    setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
 
-    // Set up and configure timer to display images every second
-    rateTimer = new QTimer;
-    connect(rateTimer, SIGNAL(timeout()), this, SLOT(updateImage()));
-    rateTimer->setInterval(1000);
+    // Display a new image every second, for as long as the countdown runs
+    connect(_clock, &AnimationClock::ticked, this, &RespawnOverlayItem::animate);
 }
 
-void RespawnOverlayItem::updateImage()
+void RespawnOverlayItem::start()
 {
-    respawnindex = (respawnindex + 1) % 6;  // The remainder of index+1 divided by 5 is the index of the image to use
-    //qDebug()<<"the index is " << respawnindex;
-    imageBrush.setTextureImage(images[respawnindex]);
-    this->setPen(Qt::NoPen);
-    this->setBrush(imageBrush);
+    _running = true;
+    _startTime = _clock->time();
+    respawnindex = -1;  // Reset respawn index so that the first image is shown on the next tick
 }
 
-void RespawnOverlayItem::ResetIndex()
+void RespawnOverlayItem::stop()
 {
-    respawnindex = -1;  // Reset respawn index for proper iteration through image array
+    _running = false;
+}
+
+void RespawnOverlayItem::animate(qint64 time)
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    int frame = AnimationClock::frameAt(time - _startTime, OVERLAY_FRAME_INTERVAL, 6);
+    if (frame != respawnindex)
+    {
+        respawnindex = frame;
+        //qDebug()<<"the index is " << respawnindex;
+        this->setOffset(offsets[respawnindex]);
+        this->setPixmap(frames[respawnindex]);
+    }
 }
@@ -1,47 +1,61 @@
 #ifndef RESPAWNOVERLAYITEM_H
 #define RESPAWNOVERLAYITEM_H
 
-#include <QGraphicsRectItem>
+#include "animationclock.h"
+
+#include <QGraphicsPixmapItem>
 #include <QPainter>
+#include <QPoint>
 #include <QObject>
 
 /*!
  * \brief RespawnOverlayItem class controls the display of a respawn counter when the player dies
  */
-class RespawnOverlayItem: public QObject, public QGraphicsRectItem
+class RespawnOverlayItem: public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
 public:
-    explicit RespawnOverlayItem();
     /*!
-     * \brief Controls the speed at which images appear on the screen
+     * \brief Constructs the overlay, stopped.
+     * \param clock the clock that animates the overlay
      */
-    QTimer* rateTimer;
+    explicit RespawnOverlayItem(AnimationClock* clock);
     /*!
      * \brief Current index of image array
      */
     int respawnindex;
     /*!
-     * \brief Resets the index for the image array
+     * \brief Starts counting down from the first image, as of the current time of the clock
+     */
+    void start();
+    /*!
+     * \brief Stops counting down
      */
-    void ResetIndex();
+    void stop();
 
 public slots:
     /*!
-     * \brief Finds the next index of image to use and displays it on the screen
+     * \brief Finds the index of image to use for the current time and displays it on the screen
+     * \param time the time of the animation clock
      */
-    void updateImage();
+    void animate(qint64 time);
 
 private:
-    QBrush imageBrush;
+    AnimationClock* _clock;
+    bool _running = false;
+    /*!
+     * \brief Time of the clock when the countdown started
+     */
+    qint64 _startTime = 0;
     /*!
      * \brief Array of images to be displayed
      */
-    QImage images[6];
-    qreal x;
-    qreal y;
-    qreal w;
-    qreal h;
+    QPixmap frames[6];
+
+    /*!
+     * \brief Where each image starts on the map, as only the visible part of each image is kept
+     */
+    QPoint offsets[6];
 };
 
 #endif // RESPAWNOVERLAYITEM_H
@@ -0,0 +1,50 @@
+# The dedicated server shares the network and map code of the game, but nothing that draws
+QT       = core network
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = crownhunters-server
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../binarystream.cpp \
+    ../gameworld.cpp \
+    ../geometry.cpp \
+    ../mapdata.cpp \
+    ../networkbase.cpp \
+    ../networkhost.cpp \
+    ../playercolor.cpp \
+    ../processusage.cpp \
+    ../projectilesystem.cpp \
+    ../spatialgrid.cpp \
+    ../timerwheel.cpp \
+    ../wallfield.cpp \
+    ../worldsnapshot.cpp \
+    dedicatedserver.cpp \
+    main.cpp
+
+HEADERS += \
+    ../binarystream.h \
+    ../gameworld.h \
+    ../geometry.h \
+    ../mapdata.h \
+    ../networkbase.h \
+    ../networkhost.h \
+    ../playercolor.h \
+    ../processusage.h \
+    ../projectilesystem.h \
+    ../settings.h \
+    ../spatialgrid.h \
+    ../timerwheel.h \
+    ../wallfield.h \
+    ../worldsnapshot.h \
+    dedicatedserver.h
+
+RESOURCES += \
+    ../maps.qrc
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,95 @@
+#include "dedicatedserver.h"
+#include "processusage.h"
+
+#include <QDebug>
+
+DedicatedServer::DedicatedServer(int gameLength, QObject* parent)
+    : QObject(parent)
+    , _host(new NetworkHost(this))
+    , _matchTimer(new QTimer(this))
+    , _gameLength(gameLength)
+{
+    _matchTimer->setSingleShot(true);
+    _matchTimer->setInterval(gameLength * 60 * 1000);
+    connect(_matchTimer, &QTimer::timeout, this, &DedicatedServer::endMatch);
+
+    connect(_host, &NetworkHost::playerJoined, this, &DedicatedServer::onPlayerJoined);
+    connect(_host, &NetworkHost::playerLeft, this, &DedicatedServer::onPlayerLeft);
+}
+
+bool DedicatedServer::start(MapData const& map, int maxPlayers, quint16 port)
+{
+    _host->setMap(map);
+    if (!_host->startDedicatedHosting(maxPlayers, QHostAddress::Any, port))
+    {
+        qWarning() << "Could not listen on port" << port;
+        return false;
+    }
+
+    qInfo() << "Hosting" << map.name << "on port" << port << "for up to" << maxPlayers << "players,"
+            << _gameLength << "minutes per match," << residentKiB() << "KiB resident";
+    return true;
+}
+
+void DedicatedServer::onPlayerJoined(PlayerColor color, QString const& username)
+{
+    qInfo() << username << "joined as" << playerColorToString(color);
+
+    if (!_host->hasGameStarted())
+    {
+        startMatch();
+    }
+}
+
+void DedicatedServer::onPlayerLeft(PlayerColor color, QString const& username)
+{
+    qInfo() << username << "left as" << playerColorToString(color);
+
+    // Nobody is left to win, so there is no point playing on
+    if (_host->hasGameStarted() && _host->usernames().isEmpty())
+    {
+        endMatch();
+    }
+}
+
+void DedicatedServer::startMatch()
+{
+    _matchCount++;
+    _matchClock.start();
+    _matchStartCpuTime = cpuTime();
+
+    _host->startGame(_gameLength);
+    _matchTimer->start();
+
+    qInfo() << "Match" << _matchCount << "started with" << _host->usernames().size() << "players";
+}
+
+void DedicatedServer::endMatch()
+{
+    _matchTimer->stop();
+
+    // Whoever holds the crown when time runs out wins; with nobody holding it, nobody does
+    PlayerColor winner = NO_PLAYER;
+    QString username;
+    if (PlayerSnapshot const* holder = _host->world().crownHolder())
+    {
+        winner = holder->color;
+        username = _host->usernames().value(holder->color);
+    }
+
+    _host->endGame(winner, username);
+
+    qint64 elapsed = _matchClock.elapsed();
+    qint64 cpu = cpuTime() - _matchStartCpuTime;
+    qInfo().nospace() << "Match " << _matchCount << " ended after " << elapsed / 1000 << " s"
+                      << (username.isEmpty() ? QString() : QStringLiteral(", won by ") + username)
+                      << ": " << cpu << " ms CPU (" << (elapsed > 0 ? 100.0 * cpu / elapsed : 0.0) << "% of a core), "
+                      << residentKiB() << " KiB resident, " << peakResidentKiB() << " KiB peak, ticks averaging "
+                      << _host->averageTickTime() << " us and at most " << _host->maxTickTime() << " us, "
+                      << _host->droppedTicks() << " dropped";
+
+    if (!_host->usernames().isEmpty())
+    {
+        startMatch();
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef DEDICATEDSERVER_H
+#define DEDICATEDSERVER_H
+
+#include "networkhost.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/*!
+ * \brief The DedicatedServer class runs matches on a NetworkHost that has no player of its own.
+ * A match starts as soon as a player joins and lasts for the configured game length, after which
+ * whoever holds the crown wins and the next match starts if anyone is still connected. The memory
+ * and CPU time each match used are logged when it ends, to tell how many servers fit on one machine.
+ */
+class DedicatedServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Constructs a server that is not listening yet.
+     * \param gameLength the length of each match, in minutes
+     * \param parent the parent object
+     */
+    explicit DedicatedServer(int gameLength = DEFAULT_GAME_LENGTH, QObject* parent = nullptr);
+
+    /*!
+     * \brief Starts listening for players.
+     * \param map the map to play, which every player receives when joining
+     * \param maxPlayers the number of players that may join
+     * \param port the port to listen on
+     * \return whether or not the server was able to listen on the port
+     */
+    bool start(MapData const& map, int maxPlayers = DEFAULT_MAX_PLAYERS, quint16 port = PORT_NUMBER);
+
+    inline NetworkHost* host() const
+    {
+        return _host;
+    }
+
+    inline int matchCount() const
+    {
+        return _matchCount;
+    }
+
+private slots:
+    void onPlayerJoined(PlayerColor color, QString const& username);
+    void onPlayerLeft(PlayerColor color, QString const& username);
+
+    /*!
+     * \brief Ends the match being played, crowning whoever holds the crown, and reports what
+     * the match used.
+     */
+    void endMatch();
+
+private:
+    void startMatch();
+
+    NetworkHost* _host;
+    QTimer* _matchTimer;
+    int _gameLength;
+    int _matchCount = 0;
+
+    /*!
+     * \brief Time since the match started
+     */
+    QElapsedTimer _matchClock;
+
+    /*!
+     * \brief CPU time (in milliseconds) the process had used when the match started
+     */
+    qint64 _matchStartCpuTime = 0;
+};
+
+#endif // DEDICATEDSERVER_H
@@ -0,0 +1,57 @@
+#include "dedicatedserver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("crownhunters-server");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("Hosts Crown Hunters matches without a player or a window."));
+    parser.addHelpOption();
+
+    QCommandLineOption portOption({ "p", "port" }, QObject::tr("Listen on <port>."),
+                                  QObject::tr("port"), QString::number(PORT_NUMBER));
+    QCommandLineOption playersOption({ "n", "max-players" }, QObject::tr("Let up to <count> players join."),
+                                     QObject::tr("count"), QString::number(DEFAULT_MAX_PLAYERS));
+    QCommandLineOption lengthOption({ "l", "game-length" }, QObject::tr("Play matches of <minutes>."),
+                                    QObject::tr("minutes"), QString::number(DEFAULT_GAME_LENGTH));
+    QCommandLineOption mapOption({ "m", "map" }, QObject::tr("Play the map in <file>."),
+                                 QObject::tr("file"), ":/maps/arena.map");
+    parser.addOption(portOption);
+    parser.addOption(playersOption);
+    parser.addOption(lengthOption);
+    parser.addOption(mapOption);
+    parser.process(a);
+
+    bool portOk = false;
+    bool playersOk = false;
+    bool lengthOk = false;
+    quint16 port = parser.value(portOption).toUShort(&portOk);
+    int maxPlayers = parser.value(playersOption).toInt(&playersOk);
+    int gameLength = parser.value(lengthOption).toInt(&lengthOk);
+
+    if (!portOk || !playersOk || maxPlayers < 1 || maxPlayers > DEFAULT_MAX_PLAYERS || !lengthOk || gameLength < 1)
+    {
+        qCritical() << "Invalid options; the port must be a number, there can be 1 to"
+                    << DEFAULT_MAX_PLAYERS << "players, and games last at least a minute";
+        return 1;
+    }
+
+    MapData map;
+    if (!MapData::load(parser.value(mapOption), map))
+    {
+        return 1;
+    }
+
+    DedicatedServer server(gameLength);
+    if (!server.start(map, maxPlayers, port))
+    {
+        return 1;
+    }
+
+    return a.exec();
+}
@@ -2,7 +2,6 @@
 #define SETTINGS_H
 
 #include <QDataStream>
-#include <QVector2D>
 #include <QtMath>
 
 /*!
@@ -15,14 +14,68 @@ const int PORT_NUMBER = 7400;
  */
 const QDataStream::Version COMPRESSION_VERSION = QDataStream::Qt_4_1;
 
+/*!
+ * \brief The version of the binary wire protocol. A host and client only exchange binary
+ * messages if both advertise this same version while joining; otherwise they fall back to JSON.
+ */
+const quint8 BINARY_PROTOCOL_VERSION = 2;
+
+/*!
+ * \brief The largest datagram (in bytes) sent over UDP, which stays below the MTU of any
+ * common path once IP and UDP headers are added, so datagrams are never fragmented.
+ */
+const int DATAGRAM_MAX_SIZE = 1200;
+
 /*!
  * \brief The number of milliseconds to wait for a message to be received before considering
  * the connection to be timed out.
  */
 const int NETWORK_TIMEOUT = 15 * 1000;
 
+/*!
+ * \brief The number of milliseconds between network ticks. All messages queued for a socket
+ * during one tick are flushed together as a single write at the end of the tick.
+ */
 const int NETWORK_UPDATE_RATE = 1 * 50;
 
+/*!
+ * \brief The width (in milliseconds) of each bucket of the outbound flush latency histogram.
+ * The last bucket collects every latency beyond the others.
+ */
+const int FLUSH_LATENCY_BUCKET_SIZE = 10;
+
+/*!
+ * \brief The number of buckets in the outbound flush latency histogram.
+ */
+const int FLUSH_LATENCY_BUCKET_COUNT = 8;
+
+/*!
+ * \brief The default number of fixed-length simulation ticks the host runs per second.
+ */
+const int SERVER_TICK_RATE = 60;
+
+/*!
+ * \brief The default number of world snapshots the host sends to each client per second.
+ */
+const int SERVER_SEND_RATE = 1000 / NETWORK_UPDATE_RATE;
+
+/*!
+ * \brief The maximum number of ticks the host runs back-to-back to catch up after a stall.
+ * Any further backlog is dropped rather than simulated.
+ */
+const int SERVER_MAX_CATCH_UP_TICKS = 5;
+
+/*!
+ * \brief The number of past snapshots the host and each client keep as possible delta baselines.
+ * A client whose last acknowledged snapshot is older than this receives a full snapshot.
+ */
+const int SNAPSHOT_HISTORY_SIZE = 32;
+
+/*!
+ * \brief The number of steps per pixel that positions are quantized to in snapshots.
+ */
+const int SNAPSHOT_POSITION_SCALE = 8;
+
 const int DEFAULT_MAX_PLAYERS = 8;
 
 const int DEFAULT_GAME_LENGTH = 3;
@@ -59,11 +112,136 @@ const double PLAYER_DECELERATION = 0.5;
  */
 const double PLAYER_MAX_VELOCITY = 4.0;
 
+/*!
+ * \brief The default number of milliseconds that remote players are drawn behind the newest
+ * position received for them. Two network ticks leaves room for one late update.
+ */
+const int INTERPOLATION_DELAY = 2 * NETWORK_UPDATE_RATE;
+
+/*!
+ * \brief The maximum number of milliseconds that a remote player keeps moving past the newest
+ * position received for them while the next one is late.
+ */
+const int INTERPOLATION_MAX_EXTRAPOLATION = NETWORK_UPDATE_RATE;
+
+/*!
+ * \brief The number of received positions kept for each remote player.
+ */
+const int INTERPOLATION_BUFFER_SIZE = 32;
+
+/*!
+ * \brief The number of milliseconds between advance frames of the game simulation.
+ */
+const int SIMULATION_STEP = 10;
+
+/*!
+ * \brief The maximum number of advance frames run back-to-back to catch up after a stall.
+ * Any further backlog is dropped, so that a slow frame cannot cause ever slower frames.
+ */
+const int SIMULATION_MAX_CATCH_UP_STEPS = 5;
+
+/*!
+ * \brief The number of milliseconds between checks for due advance frames. Between advance
+ * frames, players are drawn interpolated between their last two simulated positions.
+ */
+const int FRAME_INTERVAL = 1000 / 120;
+
+/*!
+ * \brief How much faster than PLAYER_MAX_VELOCITY the host lets a reported position move
+ * before clamping it, to allow for network jitter.
+ */
+const double PLAYER_SPEED_TOLERANCE = 1.25;
+
+/*!
+ * \brief The number of predicted advance frames the local player remembers while waiting
+ * for the host to acknowledge them.
+ */
+const int INPUT_HISTORY_SIZE = 128;
+
+/*!
+ * \brief The distance (in pixels) between the predicted and the authoritative position of
+ * the local player below which no correction is applied.
+ */
+const qreal RECONCILIATION_THRESHOLD = 0.5;
+
+/*!
+ * \brief The width and height of players, health kits and the crown, in pixels.
+ */
+const qreal PLAYER_SIZE = 25;
+
+/*!
+ * \brief The length and width of bullets, in pixels.
+ */
+const qreal BULLET_LENGTH = 13;
+const qreal BULLET_WIDTH = 4;
+
+/*!
+ * \brief The width of the outline drawn around walls, which players and bullets collide with too.
+ */
+const qreal WALL_OUTLINE_WIDTH = 4;
+
+/*!
+ * \brief The speed of bullets, in pixels per millisecond.
+ */
+const qreal BULLET_SPEED = 40.0 / 50.0;
+
+/*!
+ * \brief The farthest (in pixels) from the center of its shooter the host accepts a bullet
+ * from: the tip of a bullet at the edge of the player, plus as far as the player may have
+ * moved since the host last heard where it is.
+ */
+const qreal BULLET_MAX_SOURCE_DISTANCE = PLAYER_SIZE / 2 + BULLET_LENGTH
+                                         + PLAYER_MAX_VELOCITY * PLAYER_SPEED_TOLERANCE * NETWORK_UPDATE_RATE / SIMULATION_STEP;
+
+/*!
+ * \brief The shortest average time (in milliseconds) the host allows between a player's shots,
+ * and how many shots it accepts at once, since shots may arrive together after a delay.
+ */
+const qint64 BULLET_FIRE_INTERVAL = 100;
+const int BULLET_FIRE_BURST = 3;
+
+/*!
+ * \brief The number of bullets room is made for up front. More are made room for as needed.
+ */
+const int PROJECTILE_INITIAL_CAPACITY = 256;
+
 /*!
  * \brief The cooldown time (in milliseconds) between a player dying and respawning.
  */
 const qint64 PLAYER_RESPAWN_TIME = 5 * 1000;
 
+/*!
+ * \brief The time (in milliseconds) between waves of health kits. Each wave replaces the last.
+ */
+const int HEALTH_KIT_WAVE_INTERVAL = 15 * 1000;
+
+/*!
+ * \brief The number of slots in the wheels that schedule timed game events such as respawns.
+ * Each slot covers one simulation step.
+ */
+const int TIMER_WHEEL_SLOTS = 64;
+
+/*!
+ * \brief The time (in milliseconds) each image of the health kit animation is shown for.
+ */
+const int HEALTH_KIT_FRAME_INTERVAL = 80;
+
+/*!
+ * \brief The time (in milliseconds) each image of the respawn and game start countdowns is shown for.
+ */
+const int OVERLAY_FRAME_INTERVAL = 1000;
+
+/*!
+ * \brief The width and height (in pixels) of each cell of the grid that collision queries
+ * look up nearby walls, players and pickups in.
+ */
+const qreal SPATIAL_GRID_CELL_SIZE = 50;
+
+/*!
+ * \brief The spacing (in pixels) of the samples of the precomputed distance to the nearest wall.
+ */
+const qreal WALL_FIELD_RESOLUTION = 2;
+
 /*!
  * \brief The width of the map.
  */
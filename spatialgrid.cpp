@@ -0,0 +1,151 @@
+#include "spatialgrid.h"
+
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(QRectF const& bounds, qreal cellSize)
+    : _bounds(bounds)
+    , _cellSize(qMax(cellSize, qreal(1)))
+    , _columns(qMax(1, qCeil(bounds.width() / _cellSize)))
+    , _rows(qMax(1, qCeil(bounds.height() / _cellSize)))
+    , _cells(_columns * _rows)
+{
+
+}
+
+void SpatialGrid::update(EntityKind kind, quint32 id, QRectF const& boundingBox)
+{
+    if (!boundingBox.intersects(_bounds))
+    {
+        remove(kind, id);
+        return;
+    }
+
+    QRect range = cellRange(boundingBox);
+    Entry entry = { kind, id };
+
+    auto it = _cellRanges.find(key(kind, id));
+    if (it == _cellRanges.end())
+    {
+        insertInto(range, entry);
+        _cellRanges.insert(key(kind, id), range);
+        return;
+    }
+
+    // Most moves stay within the same cells
+    if (it.value() == range)
+    {
+        return;
+    }
+
+    removeFrom(it.value(), entry);
+    insertInto(range, entry);
+    it.value() = range;
+}
+
+void SpatialGrid::remove(EntityKind kind, quint32 id)
+{
+    auto it = _cellRanges.find(key(kind, id));
+    if (it == _cellRanges.end())
+    {
+        return;
+    }
+
+    removeFrom(it.value(), { kind, id });
+    _cellRanges.erase(it);
+}
+
+void SpatialGrid::clear(EntityKind kind)
+{
+    for (QVector<Entry>& cell : _cells)
+    {
+        cell.erase(std::remove_if(cell.begin(), cell.end(),
+                                  [kind](Entry const& entry) { return entry.kind == kind; }),
+                   cell.end());
+    }
+
+    for (auto it = _cellRanges.begin(); it != _cellRanges.end(); )
+    {
+        if (static_cast<EntityKind>(it.key() >> 32) == kind)
+        {
+            it = _cellRanges.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void SpatialGrid::query(EntityKind kind, QRectF const& area, QVector<quint32>& results) const
+{
+    results.clear();
+
+    if (!area.intersects(_bounds))
+    {
+        return;
+    }
+
+    QRect range = cellRange(area);
+    for (int row = range.top(); row <= range.bottom(); row++)
+    {
+        for (int column = range.left(); column <= range.right(); column++)
+        {
+            for (Entry const& entry : _cells[row * _columns + column])
+            {
+                if (entry.kind == kind)
+                {
+                    results.append(entry.id);
+                }
+            }
+        }
+    }
+
+    // Entities spanning several of the cells were found once per cell
+    if (range.width() > 1 || range.height() > 1)
+    {
+        std::sort(results.begin(), results.end());
+        results.erase(std::unique(results.begin(), results.end()), results.end());
+    }
+}
+
+QRect SpatialGrid::cellRange(QRectF const& area) const
+{
+    int left = qBound(0, static_cast<int>((area.left() - _bounds.left()) / _cellSize), _columns - 1);
+    int top = qBound(0, static_cast<int>((area.top() - _bounds.top()) / _cellSize), _rows - 1);
+    int right = qBound(0, static_cast<int>((area.right() - _bounds.left()) / _cellSize), _columns - 1);
+    int bottom = qBound(0, static_cast<int>((area.bottom() - _bounds.top()) / _cellSize), _rows - 1);
+
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+void SpatialGrid::insertInto(QRect const& range, Entry entry)
+{
+    for (int row = range.top(); row <= range.bottom(); row++)
+    {
+        for (int column = range.left(); column <= range.right(); column++)
+        {
+            _cells[row * _columns + column].append(entry);
+        }
+    }
+}
+
+void SpatialGrid::removeFrom(QRect const& range, Entry entry)
+{
+    for (int row = range.top(); row <= range.bottom(); row++)
+    {
+        for (int column = range.left(); column <= range.right(); column++)
+        {
+            QVector<Entry>& cell = _cells[row * _columns + column];
+            for (int i = 0; i < cell.size(); i++)
+            {
+                if (cell[i].kind == entry.kind && cell[i].id == entry.id)
+                {
+                    // Order within a cell does not matter
+                    cell[i] = cell.last();
+                    cell.removeLast();
+                    break;
+                }
+            }
+        }
+    }
+}
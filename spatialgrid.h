@@ -0,0 +1,113 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "settings.h"
+
+#include <QHash>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+
+/*!
+ * \brief The kinds of entity a SpatialGrid holds. Ids only need to be unique within a kind.
+ */
+enum class EntityKind : quint8
+{
+    Player,
+    Pickup
+};
+
+/*!
+ * \brief The SpatialGrid class is the broadphase for collision queries. It divides the map into
+ * square cells and remembers which entities' bounding boxes overlap each cell, so that a query
+ * only has to look at the entities in the cells it overlaps instead of at every entity. Static
+ * walls are handled by WallField instead.
+ */
+class SpatialGrid
+{
+public:
+    /*!
+     * \brief Creates an empty grid covering the specified area.
+     * \param bounds the area covered by the grid, in scene coordinates
+     * \param cellSize the width and height of each cell
+     */
+    explicit SpatialGrid(QRectF const& bounds = QRectF(0, 0, MAP_WIDTH, MAP_HEIGHT),
+                         qreal cellSize = SPATIAL_GRID_CELL_SIZE);
+
+    /*!
+     * \brief Adds an entity to the grid, or moves it if it is already in the grid. Entities
+     * that stay within the same cells are not touched. Entities entirely outside the grid
+     * are removed.
+     * \param kind the kind of entity
+     * \param id the id of the entity
+     * \param boundingBox the bounding box of the entity, in scene coordinates
+     */
+    void update(EntityKind kind, quint32 id, QRectF const& boundingBox);
+
+    /*!
+     * \brief Removes an entity from the grid.
+     * \param kind the kind of entity
+     * \param id the id of the entity
+     */
+    void remove(EntityKind kind, quint32 id);
+
+    /*!
+     * \brief Removes every entity of the specified kind from the grid.
+     * \param kind the kind of entity
+     */
+    void clear(EntityKind kind);
+
+    /*!
+     * \brief Finds the entities of a kind whose cells overlap the specified area. The results
+     * are only candidates: an entity in an overlapped cell does not necessarily overlap the area.
+     * \param kind the kind of entity to look for
+     * \param area the area to look in, in scene coordinates
+     * \param results the vector to put the ids of the entities in, each at most once
+     */
+    void query(EntityKind kind, QRectF const& area, QVector<quint32>& results) const;
+
+    /*!
+     * \brief Returns the number of entities of every kind in the grid.
+     */
+    inline int size() const
+    {
+        return _cellRanges.size();
+    }
+
+private:
+    struct Entry
+    {
+        EntityKind kind;
+        quint32 id;
+    };
+
+    /*!
+     * \brief Returns the range of cells (inclusive) that overlap an area, clamped to the grid
+     */
+    QRect cellRange(QRectF const& area) const;
+
+    void insertInto(QRect const& range, Entry entry);
+    void removeFrom(QRect const& range, Entry entry);
+
+    static inline quint64 key(EntityKind kind, quint32 id)
+    {
+        return (static_cast<quint64>(kind) << 32) | id;
+    }
+
+    QRectF _bounds;
+    qreal _cellSize;
+    int _columns;
+    int _rows;
+
+    /*!
+     * \brief The entries overlapping each cell, row by row
+     */
+    QVector<QVector<Entry>> _cells;
+
+    /*!
+     * \brief The range of cells each entity is currently in
+     */
+    QHash<quint64, QRect> _cellRanges;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,30 @@
+include(../tests.pri)
+
+TARGET = tst_bullethits
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../gameworld.cpp \
+    ../../geometry.cpp \
+    ../../mapdata.cpp \
+    ../../playercolor.cpp \
+    ../../projectilesystem.cpp \
+    ../../spatialgrid.cpp \
+    ../../timerwheel.cpp \
+    ../../wallfield.cpp \
+    tst_bullethits.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../gameworld.h \
+    ../../geometry.h \
+    ../../mapdata.h \
+    ../../playercolor.h \
+    ../../projectilesystem.h \
+    ../../settings.h \
+    ../../spatialgrid.h \
+    ../../timerwheel.h \
+    ../../wallfield.h
+
+RESOURCES += \
+    ../../maps.qrc
@@ -0,0 +1,176 @@
+#include "gameworld.h"
+
+#include <QtMath>
+#include <QtTest>
+
+namespace
+{
+    /*!
+     * \brief How far a bullet travels in one step. Starting a bullet at every fraction of
+     * this distance covers every way a step can line up with a wall or player.
+     */
+    const qreal STEP_TRAVEL = BULLET_SPEED * SIMULATION_STEP;
+
+    const qreal PHASE_SPACING = 0.25;
+
+    /*!
+     * \brief Enough steps for a bullet to cross the whole map.
+     */
+    const int MAX_STEPS = static_cast<int>(MAP_WIDTH / STEP_TRAVEL) + 10;
+
+    const QPointF SOURCE(100, MAP_HEIGHT / 2);
+}
+
+/*!
+ * \brief The BulletHitsTest class checks that bullets never pass through thin walls or players,
+ * however their steps line up, and measures how many bullets a step can handle.
+ */
+class BulletHitsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void thinWallsStopBullets_data();
+    void thinWallsStopBullets();
+    void bulletsHitPlayers_data();
+    void bulletsHitPlayers();
+
+    void stepThroughput_data();
+    void stepThroughput();
+};
+
+void BulletHitsTest::thinWallsStopBullets_data()
+{
+    QTest::addColumn<qreal>("thickness");
+    QTest::addColumn<qreal>("angle");
+
+    for (qreal thickness : { 0.5, 1.0, 2.0 })
+    {
+        for (qreal angle : { 0.0, 30.0, -45.0 })
+        {
+            QTest::addRow("%.1fpx at %.0f degrees", thickness, angle) << thickness << angle;
+        }
+    }
+}
+
+void BulletHitsTest::thinWallsStopBullets()
+{
+    QFETCH(qreal, thickness);
+    QFETCH(qreal, angle);
+
+    qreal const wallLeft = 300;
+
+    for (qreal phase = 0; phase < STEP_TRAVEL; phase += PHASE_SPACING)
+    {
+        GameWorld world;
+        world.addWall({ QPointF(wallLeft, 0), QPointF(wallLeft + thickness, 0),
+                        QPointF(wallLeft + thickness, MAP_HEIGHT), QPointF(wallLeft, MAP_HEIGHT) });
+        world.spawnBullet(PlayerColor::Red, SOURCE + QPointF(phase, 0), angle);
+
+        int steps = 0;
+        while (world.bullets().size() > 0 && steps < MAX_STEPS)
+        {
+            world.step();
+            steps++;
+
+            ProjectileSystem const& bullets = world.bullets();
+            for (int slot = 0; slot < bullets.capacity(); slot++)
+            {
+                if (!bullets.isAlive(slot))
+                {
+                    continue;
+                }
+
+                QPointF tip = bullets.position(slot) + bullets.direction(slot) * BULLET_LENGTH;
+                if (tip.x() > wallLeft)
+                {
+                    QFAIL(qPrintable(QStringLiteral("bullet starting %1px in passed the wall after %2 steps")
+                                     .arg(phase).arg(steps)));
+                }
+            }
+        }
+
+        QCOMPARE(world.bullets().size(), 0);
+    }
+}
+
+void BulletHitsTest::bulletsHitPlayers_data()
+{
+    qreal const reach = PLAYER_SIZE / 2 + BULLET_WIDTH / 2;
+
+    QTest::addColumn<qreal>("offset");
+    QTest::addColumn<bool>("hits");
+
+    QTest::newRow("head on") << 0.0 << true;
+    QTest::newRow("grazing") << reach - 0.5 << true;
+    QTest::newRow("near miss") << reach + 0.5 << false;
+}
+
+void BulletHitsTest::bulletsHitPlayers()
+{
+    QFETCH(qreal, offset);
+    QFETCH(bool, hits);
+
+    for (qreal phase = 0; phase < STEP_TRAVEL; phase += PHASE_SPACING)
+    {
+        GameWorld world;
+
+        // The bullet's path passes offset pixels from the center of the player
+        world.addPlayer(PlayerColor::Blue, QPointF(400, SOURCE.y() + offset) - QPointF(PLAYER_SIZE, PLAYER_SIZE) / 2);
+        world.spawnBullet(PlayerColor::Red, SOURCE + QPointF(phase, 0), 0.0);
+
+        for (int steps = 0; world.bullets().size() > 0 && steps < MAX_STEPS; steps++)
+        {
+            world.step();
+        }
+
+        int expected = hits ? PLAYER_MAX_HEALTH - BULLET_DAMAGE : PLAYER_MAX_HEALTH;
+        if (world.player(PlayerColor::Blue)->health != expected)
+        {
+            QFAIL(qPrintable(QStringLiteral("bullet starting %1px in left the player with %2 health")
+                             .arg(phase).arg(world.player(PlayerColor::Blue)->health)));
+        }
+    }
+}
+
+void BulletHitsTest::stepThroughput_data()
+{
+    QTest::addColumn<int>("bulletCount");
+
+    QTest::newRow("64 bullets") << 64;
+    QTest::newRow("256 bullets") << 256;
+    QTest::newRow("1024 bullets") << 1024;
+}
+
+void BulletHitsTest::stepThroughput()
+{
+    QFETCH(int, bulletCount);
+
+    MapData map;
+    QVERIFY(MapData::load(QStringLiteral(":/maps/arena.map"), map));
+
+    GameWorld world;
+    world.loadMap(map);
+    for (int i = 0; i < map.spawns.size(); i++)
+    {
+        world.addPlayer(static_cast<PlayerColor>(i), map.spawns[i]);
+    }
+
+    // Keep the same number of bullets in flight, fired from every spawn point in every direction
+    int fired = 0;
+    QBENCHMARK
+    {
+        while (world.bullets().size() < bulletCount)
+        {
+            QPointF source = map.spawns[fired % map.spawns.size()];
+            world.spawnBullet(static_cast<PlayerColor>(fired % map.spawns.size()), source, fired * 37.0);
+            fired++;
+        }
+
+        world.step();
+    }
+}
+
+QTEST_GUILESS_MAIN(BulletHitsTest)
+
+#include "tst_bullethits.moc"
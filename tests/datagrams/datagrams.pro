@@ -0,0 +1,21 @@
+include(../tests.pri)
+
+QT       += network
+
+TARGET = tst_datagrams
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../mapdata.cpp \
+    ../../networkbase.cpp \
+    ../../playercolor.cpp \
+    ../../worldsnapshot.cpp \
+    tst_datagrams.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../mapdata.h \
+    ../../networkbase.h \
+    ../../playercolor.h \
+    ../../settings.h \
+    ../../worldsnapshot.h
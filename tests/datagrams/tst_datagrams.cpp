@@ -0,0 +1,283 @@
+#include "networkbase.h"
+
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest>
+
+namespace
+{
+    /*!
+     * \brief LoopbackPeer is a bare NetworkBase that records the unreliable messages it receives.
+     */
+    class LoopbackPeer : public NetworkBase
+    {
+    public:
+        using NetworkBase::bindDatagramSocket;
+        using NetworkBase::datagramPort;
+        using NetworkBase::flushOutbound;
+        using NetworkBase::onReadyRead;
+        using NetworkBase::oversizeDatagramPayloads;
+        using NetworkBase::positionMessage;
+        using NetworkBase::sendMessage;
+        using NetworkBase::setDatagramPeer;
+        using NetworkBase::setWireFormat;
+        using NetworkBase::snapshotMessage;
+        using NetworkBase::staleDatagrams;
+
+        QVector<quint32> inputSequences;
+        QVector<WorldSnapshot> snapshots;
+
+    protected:
+        void receivedFrom(QAbstractSocket*) override { }
+
+        void onParsedPositionMessage(PlayerColor, QPointF, quint32 inputSequence) override
+        {
+            inputSequences.append(inputSequence);
+        }
+
+        void onParsedSnapshotMessage(WorldSnapshot const& snapshot) override
+        {
+            snapshots.append(snapshot);
+        }
+    };
+
+    /*!
+     * \brief LossyRelay forwards datagrams on the loopback interface, dropping some of them and
+     * holding others back until the next one has been forwarded.
+     */
+    class LossyRelay
+    {
+    public:
+        LossyRelay(quint16 targetPort, int lossPercent, int reorderPercent)
+            : _targetPort(targetPort)
+            , _lossPercent(lossPercent)
+            , _reorderPercent(reorderPercent)
+            , _random(42)
+        {
+            _socket.bind(QHostAddress::LocalHost);
+            QObject::connect(&_socket, &QUdpSocket::readyRead, [this] { onReadyRead(); });
+        }
+
+        quint16 port() const { return _socket.localPort(); }
+        int received() const { return _received; }
+        int dropped() const { return _dropped; }
+        int reordered() const { return _reordered; }
+        int largestDatagram() const { return _largestDatagram; }
+
+        void setLossPercent(int lossPercent) { _lossPercent = lossPercent; }
+        void setReorderPercent(int reorderPercent) { _reorderPercent = reorderPercent; }
+
+    private:
+        void onReadyRead()
+        {
+            while (_socket.hasPendingDatagrams())
+            {
+                QByteArray datagram = _socket.receiveDatagram().data();
+                _received++;
+                _largestDatagram = qMax(_largestDatagram, datagram.size());
+
+                if (static_cast<int>(_random.bounded(100)) < _lossPercent)
+                {
+                    _dropped++;
+                }
+                else if (_held.isEmpty() && static_cast<int>(_random.bounded(100)) < _reorderPercent)
+                {
+                    _held = datagram;
+                }
+                else
+                {
+                    _socket.writeDatagram(datagram, QHostAddress::LocalHost, _targetPort);
+
+                    if (!_held.isEmpty())
+                    {
+                        _socket.writeDatagram(_held, QHostAddress::LocalHost, _targetPort);
+                        _held.clear();
+                        _reordered++;
+                    }
+                }
+            }
+        }
+
+        QUdpSocket _socket;
+        quint16 _targetPort;
+        int _lossPercent;
+        int _reorderPercent;
+        QRandomGenerator _random;
+        QByteArray _held;
+        int _received = 0;
+        int _dropped = 0;
+        int _reordered = 0;
+        int _largestDatagram = 0;
+    };
+
+    WorldSnapshot snapshotOfSize(int playerCount)
+    {
+        WorldSnapshot snapshot;
+        snapshot.tick = 1;
+        for (int i = 0; i < playerCount; i++)
+        {
+            PlayerSnapshot player;
+            player.position = QPointF(i, i);
+            player.health = i;
+            snapshot.players.append(player);
+        }
+        return snapshot;
+    }
+}
+
+/*!
+ * \brief The DatagramsTest class sends unreliable messages between two peers on the loopback
+ * interface, through a relay that loses and reorders datagrams.
+ */
+class DatagramsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void latestStateSurvivesLossAndReordering();
+    void splitsFlushesAtDatagramMaxSize();
+    void sendsOversizePayloadsReliably();
+
+private:
+    void connectPeers(int lossPercent, int reorderPercent);
+
+    QTcpServer* _server = nullptr;
+    QTcpSocket* _senderSocket = nullptr;
+    QTcpSocket* _receiverSocket = nullptr;
+    LoopbackPeer* _sender = nullptr;
+    LoopbackPeer* _receiver = nullptr;
+    LossyRelay* _relay = nullptr;
+};
+
+void DatagramsTest::init()
+{
+    _server = new QTcpServer(this);
+    QVERIFY(_server->listen(QHostAddress::LocalHost));
+
+    _senderSocket = new QTcpSocket(this);
+    _senderSocket->connectToHost(QHostAddress::LocalHost, _server->serverPort());
+    QVERIFY(_senderSocket->waitForConnected());
+    QVERIFY(_server->waitForNewConnection(1000));
+    _receiverSocket = _server->nextPendingConnection();
+
+    _sender = new LoopbackPeer;
+    _receiver = new LoopbackPeer;
+    QVERIFY(_sender->bindDatagramSocket(QHostAddress::LocalHost));
+    QVERIFY(_receiver->bindDatagramSocket(QHostAddress::LocalHost));
+
+    _sender->setWireFormat(_senderSocket, NetworkBase::WireFormat::BINARY_FORMAT);
+
+    QTcpSocket* receiverSocket = _receiverSocket;
+    LoopbackPeer* receiver = _receiver;
+    connect(receiverSocket, &QTcpSocket::readyRead, receiver, [=] { receiver->onReadyRead(receiverSocket); });
+}
+
+void DatagramsTest::cleanup()
+{
+    delete _relay;
+    delete _sender;
+    delete _receiver;
+    delete _senderSocket;
+    delete _server;
+    _relay = nullptr;
+    _sender = nullptr;
+    _receiver = nullptr;
+    _server = nullptr;
+    _senderSocket = nullptr;
+    _receiverSocket = nullptr;
+}
+
+void DatagramsTest::connectPeers(int lossPercent, int reorderPercent)
+{
+    // Both peers see the relay as the other's UDP endpoint
+    _relay = new LossyRelay(_receiver->datagramPort(), lossPercent, reorderPercent);
+    _sender->setDatagramPeer(_senderSocket, QHostAddress::LocalHost, _relay->port());
+    _receiver->setDatagramPeer(_receiverSocket, QHostAddress::LocalHost, _relay->port());
+}
+
+void DatagramsTest::latestStateSurvivesLossAndReordering()
+{
+    connectPeers(20, 20);
+
+    int const ticks = 200;
+    for (int tick = 1; tick <= ticks; tick++)
+    {
+        _sender->sendMessage(_senderSocket, LoopbackPeer::positionMessage(PlayerColor::Red, QPointF(tick, 0), tick));
+        _sender->flushOutbound(_senderSocket);
+        QTest::qWait(1);
+    }
+
+    // Once the link recovers, the newest position still gets through
+    _relay->setLossPercent(0);
+    _relay->setReorderPercent(0);
+    _sender->sendMessage(_senderSocket, LoopbackPeer::positionMessage(PlayerColor::Red, QPointF(ticks + 1, 0), ticks + 1));
+    _sender->flushOutbound(_senderSocket);
+    QTRY_VERIFY(!_receiver->inputSequences.isEmpty() && _receiver->inputSequences.last() == quint32(ticks + 1));
+
+    QVERIFY(_relay->dropped() > 0);
+    QVERIFY(_relay->reordered() > 0);
+
+    // A datagram overtaken by a later tick is dropped instead of rolling the state back
+    QCOMPARE(_receiver->staleDatagrams(), qint64(_relay->reordered()));
+    for (int i = 1; i < _receiver->inputSequences.size(); i++)
+    {
+        QVERIFY(_receiver->inputSequences[i] > _receiver->inputSequences[i - 1]);
+    }
+}
+
+void DatagramsTest::splitsFlushesAtDatagramMaxSize()
+{
+    // Every datagram of the flush is reordered, so the second one arrives first
+    connectPeers(0, 100);
+
+    // A snapshot that fits in a datagram on its own, but not alongside the positions
+    int playerCount = 1;
+    while (NetworkBase::encode(LoopbackPeer::snapshotMessage(snapshotOfSize(playerCount + 1), WorldSnapshot()), NetworkBase::WireFormat::BINARY_FORMAT).size() <= DATAGRAM_MAX_SIZE - 64)
+    {
+        playerCount++;
+    }
+
+    int const positions = 8;
+    for (int i = 0; i < positions; i++)
+    {
+        PlayerColor color = static_cast<PlayerColor>(i);
+        _sender->sendMessage(_senderSocket, LoopbackPeer::positionMessage(color, QPointF(i, i), i + 1));
+    }
+    _sender->sendMessage(_senderSocket, LoopbackPeer::snapshotMessage(snapshotOfSize(playerCount), WorldSnapshot()));
+    _sender->flushOutbound(_senderSocket);
+
+    QTRY_COMPARE(_receiver->inputSequences.size(), positions);
+    QTRY_COMPARE(_receiver->snapshots.size(), 1);
+    QCOMPARE(_receiver->snapshots.first().players.size(), playerCount);
+
+    // Both halves of the flush share a sequence number, so neither is considered stale
+    QCOMPARE(_relay->received(), 2);
+    QCOMPARE(_relay->reordered(), 1);
+    QCOMPARE(_receiver->staleDatagrams(), qint64(0));
+    QVERIFY(_relay->largestDatagram() <= DATAGRAM_MAX_SIZE);
+    QCOMPARE(_sender->oversizeDatagramPayloads(), qint64(0));
+}
+
+void DatagramsTest::sendsOversizePayloadsReliably()
+{
+    connectPeers(0, 0);
+
+    WorldSnapshot snapshot = snapshotOfSize(100);
+    QVERIFY(NetworkBase::encode(LoopbackPeer::snapshotMessage(snapshot, WorldSnapshot()), NetworkBase::WireFormat::BINARY_FORMAT).size() > DATAGRAM_MAX_SIZE);
+
+    _sender->sendMessage(_senderSocket, LoopbackPeer::snapshotMessage(snapshot, WorldSnapshot()));
+    _sender->flushOutbound(_senderSocket);
+
+    QTRY_COMPARE(_receiver->snapshots.size(), 1);
+    QCOMPARE(_receiver->snapshots.first().players.size(), snapshot.players.size());
+    QCOMPARE(_sender->oversizeDatagramPayloads(), qint64(1));
+    QCOMPARE(_relay->received(), 0);
+}
+
+QTEST_GUILESS_MAIN(DatagramsTest)
+
+#include "tst_datagrams.moc"
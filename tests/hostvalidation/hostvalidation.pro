@@ -0,0 +1,38 @@
+include(../tests.pri)
+
+QT       += network
+
+TARGET = tst_hostvalidation
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../gameworld.cpp \
+    ../../geometry.cpp \
+    ../../mapdata.cpp \
+    ../../networkbase.cpp \
+    ../../networkhost.cpp \
+    ../../playercolor.cpp \
+    ../../projectilesystem.cpp \
+    ../../spatialgrid.cpp \
+    ../../timerwheel.cpp \
+    ../../wallfield.cpp \
+    ../../worldsnapshot.cpp \
+    tst_hostvalidation.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../gameworld.h \
+    ../../geometry.h \
+    ../../mapdata.h \
+    ../../networkbase.h \
+    ../../networkhost.h \
+    ../../playercolor.h \
+    ../../projectilesystem.h \
+    ../../settings.h \
+    ../../spatialgrid.h \
+    ../../timerwheel.h \
+    ../../wallfield.h \
+    ../../worldsnapshot.h
+
+RESOURCES += \
+    ../../maps.qrc
@@ -0,0 +1,263 @@
+#include "networkhost.h"
+
+#include <QTcpSocket>
+#include <QtTest>
+
+namespace
+{
+    const QString ARENA_PATH = QStringLiteral(":/maps/arena.map");
+
+    /*!
+     * \brief TestHost is a NetworkHost whose message factories are open to the test, which uses
+     * them to play the part of its clients.
+     */
+    class TestHost : public NetworkHost
+    {
+    public:
+        using NetworkBase::bulletMessage;
+        using NetworkBase::chatMessage;
+        using NetworkBase::frame;
+        using NetworkBase::joinRequest;
+        using NetworkBase::positionMessage;
+    };
+}
+
+/*!
+ * \brief The HostValidationTest class sends a dedicated host what a misbehaving client could
+ * send it on the loopback interface, and checks that the host does not let it into the world.
+ */
+class HostValidationTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void joinColors_data();
+    void joinColors();
+    void joinTwice();
+    void bulletSources_data();
+    void bulletSources();
+    void fireRate();
+    void positions_data();
+    void positions();
+    void healthOfAbsentPlayer();
+    void hostingOnTakenPort();
+
+private:
+    /*!
+     * \brief Connects a new client to the host and asks to join as the specified player.
+     * \return the socket of the client
+     */
+    QTcpSocket* join(PlayerColor color, QString const& username);
+
+    void send(QTcpSocket* socket, NetworkBase::Message const& message);
+
+    /*!
+     * \brief Sends a chat message and waits for the host to receive it, by which time the host
+     * has handled everything sent before it.
+     */
+    void sync(QTcpSocket* socket, PlayerColor color);
+
+    /*!
+     * \brief Returns the center of the specified player where it spawns.
+     */
+    QPointF spawnCenter(PlayerColor color) const;
+
+    MapData _arena;
+    TestHost* _host = nullptr;
+    int _bullets = 0;
+    int _chats = 0;
+};
+
+void HostValidationTest::initTestCase()
+{
+    QVERIFY(MapData::load(ARENA_PATH, _arena));
+}
+
+void HostValidationTest::init()
+{
+    _host = new TestHost();
+    _host->setMap(_arena);
+    QVERIFY(_host->startDedicatedHosting(DEFAULT_MAX_PLAYERS, QHostAddress::LocalHost, 0));
+
+    _bullets = 0;
+    _chats = 0;
+    connect(_host, &NetworkBase::bulletUpdated, this, [this] { _bullets++; });
+    connect(_host, &NetworkBase::receivedChatMessage, this, [this] { _chats++; });
+}
+
+void HostValidationTest::cleanup()
+{
+    _host->stopHosting();
+    delete _host;
+    _host = nullptr;
+}
+
+QTcpSocket* HostValidationTest::join(PlayerColor color, QString const& username)
+{
+    QTcpSocket* socket = new QTcpSocket(_host);
+    socket->connectToHost(QHostAddress::LocalHost, _host->port());
+    send(socket, TestHost::joinRequest(color, username));
+    return socket;
+}
+
+void HostValidationTest::send(QTcpSocket* socket, NetworkBase::Message const& message)
+{
+    socket->write(TestHost::frame(NetworkBase::encode(message, NetworkBase::BINARY_FORMAT)));
+    socket->flush();
+}
+
+void HostValidationTest::sync(QTcpSocket* socket, PlayerColor color)
+{
+    int chats = _chats;
+    send(socket, TestHost::chatMessage(color, QStringLiteral("Blue"), QStringLiteral("sync")));
+    QTRY_COMPARE(_chats, chats + 1);
+}
+
+QPointF HostValidationTest::spawnCenter(PlayerColor color) const
+{
+    return _arena.spawn(static_cast<int>(color)) + QPointF(PLAYER_SIZE, PLAYER_SIZE) / 2;
+}
+
+void HostValidationTest::joinColors_data()
+{
+    QTest::addColumn<int>("color");
+    QTest::addColumn<bool>("accepted");
+
+    QTest::newRow("last color") << static_cast<int>(PlayerColor::Gray) << true;
+    QTest::newRow("past the last color") << static_cast<int>(PlayerColor::Gray) + 1 << false;
+    QTest::newRow("far out of range") << 200 << false;
+}
+
+void HostValidationTest::joinColors()
+{
+    QFETCH(int, color);
+    QFETCH(bool, accepted);
+
+    // Whether or not the join succeeds, the host responds to it
+    QTcpSocket* client = join(static_cast<PlayerColor>(color), QStringLiteral("Player"));
+    QTRY_VERIFY(client->bytesAvailable() > 0);
+
+    QCOMPARE(_host->usernames().size(), accepted ? 1 : 0);
+    QCOMPARE(_host->gameWorld().players().size(), accepted ? 1 : 0);
+}
+
+void HostValidationTest::joinTwice()
+{
+    QTcpSocket* client = join(PlayerColor::Blue, QStringLiteral("Blue"));
+    QTRY_VERIFY(_host->usernames().contains(PlayerColor::Blue));
+
+    send(client, TestHost::joinRequest(PlayerColor::Green, QStringLiteral("Green")));
+    sync(client, PlayerColor::Blue);
+
+    QCOMPARE(_host->usernames().size(), 1);
+    QVERIFY(_host->usernames().contains(PlayerColor::Blue));
+    QCOMPARE(_host->gameWorld().players().size(), 1);
+}
+
+void HostValidationTest::bulletSources_data()
+{
+    QTest::addColumn<QPointF>("offset");
+    QTest::addColumn<bool>("accepted");
+
+    QTest::newRow("from the center") << QPointF(0, 0) << true;
+    QTest::newRow("just in reach") << QPointF(BULLET_MAX_SOURCE_DISTANCE - 1, 0) << true;
+    QTest::newRow("just out of reach") << QPointF(0, BULLET_MAX_SOURCE_DISTANCE + 1) << false;
+    QTest::newRow("across the map") << QPointF(MAP_WIDTH / 2, 0) << false;
+    QTest::newRow("not a number") << QPointF(qQNaN(), 0) << false;
+    QTest::newRow("infinitely far") << QPointF(0, qInf()) << false;
+}
+
+void HostValidationTest::bulletSources()
+{
+    QFETCH(QPointF, offset);
+    QFETCH(bool, accepted);
+
+    QTcpSocket* client = join(PlayerColor::Blue, QStringLiteral("Blue"));
+    QTRY_VERIFY(_host->usernames().contains(PlayerColor::Blue));
+
+    send(client, TestHost::bulletMessage(PlayerColor::Blue, spawnCenter(PlayerColor::Blue) + offset, 45.0));
+    sync(client, PlayerColor::Blue);
+
+    QCOMPARE(_bullets, accepted ? 1 : 0);
+}
+
+void HostValidationTest::fireRate()
+{
+    QTcpSocket* client = join(PlayerColor::Blue, QStringLiteral("Blue"));
+    QTRY_VERIFY(_host->usernames().contains(PlayerColor::Blue));
+
+    // A burst goes through at once, but nothing more until the fire interval has passed
+    for (int i = 0; i < BULLET_FIRE_BURST + 2; i++)
+    {
+        send(client, TestHost::bulletMessage(PlayerColor::Blue, spawnCenter(PlayerColor::Blue), i * 10.0));
+    }
+    sync(client, PlayerColor::Blue);
+    QCOMPARE(_bullets, BULLET_FIRE_BURST);
+
+    QTest::qWait(2 * BULLET_FIRE_INTERVAL);
+    send(client, TestHost::bulletMessage(PlayerColor::Blue, spawnCenter(PlayerColor::Blue), 0.0));
+    QTRY_COMPARE(_bullets, BULLET_FIRE_BURST + 1);
+}
+
+void HostValidationTest::positions_data()
+{
+    QTest::addColumn<QPointF>("offset");
+    QTest::addColumn<bool>("moves");
+
+    QTest::newRow("in the open") << QPointF(-100, 0) << true;
+    QTest::newRow("through a wall") << QPointF(100, 0) << false;
+    QTest::newRow("not a number") << QPointF(qQNaN(), 0) << false;
+    QTest::newRow("infinitely far") << QPointF(qInf(), qInf()) << false;
+}
+
+void HostValidationTest::positions()
+{
+    QFETCH(QPointF, offset);
+    QFETCH(bool, moves);
+
+    // A thin wall just to the right of where Blue spawns
+    QPointF spawn = _arena.spawn(static_cast<int>(PlayerColor::Blue));
+    MapWall wall;
+    wall.corners = { spawn + QPointF(60, -50), spawn + QPointF(62, -50),
+                     spawn + QPointF(62, 80), spawn + QPointF(60, 80) };
+    MapData map = _arena;
+    map.walls.append(wall);
+    _host->setMap(map);
+
+    QTcpSocket* client = join(PlayerColor::Blue, QStringLiteral("Blue"));
+    QTRY_VERIFY(_host->usernames().contains(PlayerColor::Blue));
+
+    // Wait long enough for the move to be within the speed limit
+    send(client, TestHost::positionMessage(PlayerColor::Blue, spawn, 1));
+    QTest::qWait(300);
+    send(client, TestHost::positionMessage(PlayerColor::Blue, spawn + offset, 2));
+    sync(client, PlayerColor::Blue);
+
+    QCOMPARE(_host->gameWorld().player(PlayerColor::Blue)->position, moves ? spawn + offset : spawn);
+}
+
+void HostValidationTest::healthOfAbsentPlayer()
+{
+    _host->sendHealthUpdate(PlayerColor::Green, PLAYER_MAX_HEALTH, true);
+
+    QVERIFY(_host->world().player(PlayerColor::Green) == nullptr);
+    QVERIFY(_host->gameWorld().player(PlayerColor::Green) == nullptr);
+}
+
+void HostValidationTest::hostingOnTakenPort()
+{
+    TestHost other;
+    int started = 0;
+    connect(&other, &NetworkHost::startedHosting, this, [&started] { started++; });
+
+    QVERIFY(!other.startDedicatedHosting(DEFAULT_MAX_PLAYERS, QHostAddress::LocalHost, _host->port()));
+    QCOMPARE(started, 0);
+}
+
+QTEST_GUILESS_MAIN(HostValidationTest)
+
+#include "tst_hostvalidation.moc"
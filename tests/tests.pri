@@ -0,0 +1,7 @@
+# Shared by every test under tests/, which build against the game's sources directly
+QT       += testlib
+QT       -= gui
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/..
@@ -0,0 +1,8 @@
+# Each test is its own executable, so "make check" runs them one after another
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bullethits \
+    datagrams \
+    hostvalidation \
+    wallfield
@@ -0,0 +1,208 @@
+#include "geometry.h"
+#include "mapdata.h"
+#include "wallfield.h"
+
+#include <QtMath>
+#include <QtTest>
+
+#include <limits>
+
+namespace
+{
+    // The radii GameWorld tests players and bullets against walls with
+    const qreal PLAYER_REACH = PLAYER_SIZE / 2 + WALL_OUTLINE_WIDTH / 2;
+    const qreal BULLET_REACH = BULLET_WIDTH / 2 + WALL_OUTLINE_WIDTH / 2;
+
+    /*!
+     * \brief The spacing of the sampled grid, chosen so that samples do not line up with
+     * the corners of the walls or the samples of the field.
+     */
+    const qreal SAMPLE_SPACING = 3.7;
+
+    bool containsPoint(QVector<QVector<QPointF>> const& walls, QPointF point)
+    {
+        for (QVector<QPointF> const& wall : walls)
+        {
+            if (polygonContainsPoint(wall, point))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*!
+     * \brief Returns the exact signed distance to the nearest wall edge, negative inside walls.
+     */
+    qreal signedDistance(QVector<QVector<QPointF>> const& walls, QPointF point)
+    {
+        qreal nearest = std::numeric_limits<qreal>::max();
+        for (QVector<QPointF> const& wall : walls)
+        {
+            for (int i = 0, j = wall.size() - 1; i < wall.size(); j = i++)
+            {
+                nearest = qMin(nearest, distanceSquaredToSegment(point, wall[j], wall[i]));
+            }
+        }
+
+        qreal distance = qSqrt(nearest);
+        return containsPoint(walls, point) ? -distance : distance;
+    }
+
+    /*!
+     * \brief Tests a capsule against every wall polygon, the way collisions were tested
+     * before walls were baked into a field.
+     */
+    bool capsuleIntersectsWalls(QVector<QVector<QPointF>> const& walls, QPointF a, QPointF b, qreal radius)
+    {
+        if (containsPoint(walls, a) || containsPoint(walls, b))
+        {
+            return true;
+        }
+
+        qreal radiusSquared = radius * radius;
+        for (QVector<QPointF> const& wall : walls)
+        {
+            for (int i = 0, j = wall.size() - 1; i < wall.size(); j = i++)
+            {
+                if (distanceSquaredBetweenSegments(a, b, wall[j], wall[i]) < radiusSquared)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+}
+
+/*!
+ * \brief The WallFieldTest class checks the baked wall field against exact polygon tests on
+ * a grid of points covering the arena.
+ */
+class WallFieldTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void distanceIsWithinTolerance();
+    void circlesMatchPolygons_data();
+    void circlesMatchPolygons();
+    void capsulesMatchPolygons_data();
+    void capsulesMatchPolygons();
+
+private:
+    QVector<QVector<QPointF>> _walls;
+    WallField _field;
+};
+
+void WallFieldTest::initTestCase()
+{
+    MapData map;
+    QVERIFY(MapData::load(QStringLiteral(":/maps/arena.map"), map));
+
+    for (MapWall const& wall : qAsConst(map.walls))
+    {
+        _walls.append(wall.corners);
+    }
+
+    // A sliver much thinner than the sample spacing, which the samples alone cannot see
+    _walls.append({ QPointF(600, 300), QPointF(700, 360), QPointF(700.5, 359.2), QPointF(600.5, 299.2) });
+
+    _field.bake(_walls);
+    QVERIFY(!_field.isEmpty());
+}
+
+void WallFieldTest::distanceIsWithinTolerance()
+{
+    // Interpolating between samples is off by at most the diagonal of a sample cell
+    qreal const tolerance = WALL_FIELD_RESOLUTION * M_SQRT2 + 0.001;
+
+    for (qreal y = 1.1; y < MAP_HEIGHT; y += SAMPLE_SPACING)
+    {
+        for (qreal x = 1.1; x < MAP_WIDTH; x += SAMPLE_SPACING)
+        {
+            QPointF point(x, y);
+            qreal exact = signedDistance(_walls, point);
+            qreal sampled = _field.distance(point);
+
+            if (qAbs(sampled - exact) > tolerance)
+            {
+                QFAIL(qPrintable(QStringLiteral("distance at (%1, %2) is %3, expected %4")
+                                 .arg(x).arg(y).arg(sampled).arg(exact)));
+            }
+        }
+    }
+}
+
+void WallFieldTest::circlesMatchPolygons_data()
+{
+    QTest::addColumn<qreal>("radius");
+
+    QTest::newRow("player") << PLAYER_REACH;
+    QTest::newRow("bullet") << BULLET_REACH;
+}
+
+void WallFieldTest::circlesMatchPolygons()
+{
+    QFETCH(qreal, radius);
+
+    int hits = 0;
+    for (qreal y = 1.1; y < MAP_HEIGHT; y += SAMPLE_SPACING)
+    {
+        for (qreal x = 1.1; x < MAP_WIDTH; x += SAMPLE_SPACING)
+        {
+            QPointF center(x, y);
+            bool expected = capsuleIntersectsWalls(_walls, center, center, radius);
+
+            if (_field.intersectsCircle(center, radius) != expected)
+            {
+                QFAIL(qPrintable(QStringLiteral("circle at (%1, %2) should %3the walls")
+                                 .arg(x).arg(y).arg(expected ? QString() : QStringLiteral("not "))));
+            }
+
+            hits += expected;
+        }
+    }
+
+    // Make sure the grid covers both open space and walls
+    QVERIFY(hits > 0);
+}
+
+void WallFieldTest::capsulesMatchPolygons_data()
+{
+    QTest::addColumn<qreal>("length");
+
+    QTest::newRow("bullet") << BULLET_LENGTH;
+    QTest::newRow("fast bullet") << BULLET_LENGTH * 4;
+}
+
+void WallFieldTest::capsulesMatchPolygons()
+{
+    QFETCH(qreal, length);
+
+    int sample = 0;
+    for (qreal y = 1.1; y < MAP_HEIGHT; y += SAMPLE_SPACING)
+    {
+        for (qreal x = 1.1; x < MAP_WIDTH; x += SAMPLE_SPACING)
+        {
+            // Turn every capsule a little further than the last, so all directions are covered
+            qreal angle = qDegreesToRadians(37.0 * sample++);
+            QPointF a(x, y);
+            QPointF b = a + QPointF(qCos(angle), qSin(angle)) * length;
+
+            bool expected = capsuleIntersectsWalls(_walls, a, b, BULLET_REACH);
+            if (_field.intersectsCapsule(a, b, BULLET_REACH) != expected)
+            {
+                QFAIL(qPrintable(QStringLiteral("capsule from (%1, %2) to (%3, %4) should %5the walls")
+                                 .arg(a.x()).arg(a.y()).arg(b.x()).arg(b.y())
+                                 .arg(expected ? QString() : QStringLiteral("not "))));
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(WallFieldTest)
+
+#include "tst_wallfield.moc"
@@ -0,0 +1,20 @@
+include(../tests.pri)
+
+TARGET = tst_wallfield
+
+SOURCES += \
+    ../../binarystream.cpp \
+    ../../geometry.cpp \
+    ../../mapdata.cpp \
+    ../../wallfield.cpp \
+    tst_wallfield.cpp
+
+HEADERS += \
+    ../../binarystream.h \
+    ../../geometry.h \
+    ../../mapdata.h \
+    ../../settings.h \
+    ../../wallfield.h
+
+RESOURCES += \
+    ../../maps.qrc
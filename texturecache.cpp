@@ -0,0 +1,206 @@
+#include "texturecache.h"
+#include "assetbundle.h"
+
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+namespace
+{
+    /*!
+     * \brief Decodes an image straight into the format the raster paint engine blends fastest,
+     * so that drawing it never converts it again.
+     */
+    QImage decode(QString const& path)
+    {
+        return QImage(path).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+}
+
+TextureCache& TextureCache::instance()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+void TextureCache::preload(std::function<void(int, int)> const& progress)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Images in the asset bundle are already decoded, and only need a view over their pixels
+    QStringList paths;
+    QDirIterator it(":/images", { "*.png" }, QDir::Files);
+    while (it.hasNext())
+    {
+        QString path = it.next();
+        if (_images.contains(path))
+        {
+            continue;
+        }
+
+        QImage mapped = AssetBundle::instance().image(path);
+        if (!mapped.isNull())
+        {
+            // A pixmap would be a private copy of the pixels, so it is only made once
+            //  something draws the image
+            _mappedBytes += mapped.sizeInBytes();
+            _images.insert(path, mapped);
+        }
+        else
+        {
+            paths.append(path);
+        }
+    }
+
+    // Decoding is thread safe, but the cache is not: decode on the thread pool, and only
+    //  store the results once they are all back on this thread
+    QFuture<QImage> future = QtConcurrent::mapped(paths, decode);
+
+    QFutureWatcher<QImage> watcher;
+    QEventLoop loop;
+    QObject::connect(&watcher, &QFutureWatcher<QImage>::progressValueChanged, [&](int done)
+    {
+        if (progress)
+        {
+            progress(done, paths.size());
+        }
+    });
+    QObject::connect(&watcher, &QFutureWatcher<QImage>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(future);
+    if (!paths.isEmpty())
+    {
+        loop.exec();
+    }
+
+    for (int i = 0; i < paths.size(); i++)
+    {
+        QImage decoded = future.resultAt(i);
+        if (decoded.isNull())
+        {
+            qWarning() << "Could not decode texture" << paths[i];
+        }
+
+        _residentBytes += decoded.sizeInBytes();
+        _images.insert(paths[i], decoded);
+
+        // Pixmaps can only be made on the GUI thread
+        _pixmaps.insert(paths[i], QPixmap::fromImage(decoded));
+    }
+    _decodeTime += timer.elapsed();
+
+    qDebug() << "Loaded" << _images.size() << "textures in" << timer.elapsed() << "ms,"
+             << paths.size() << "decoded," << _residentBytes / 1024 << "KiB resident,"
+             << _mappedBytes / 1024 << "KiB mapped";
+}
+
+QImage TextureCache::image(QString const& path)
+{
+    auto it = _images.constFind(path);
+    if (it != _images.constEnd())
+    {
+        return it.value();
+    }
+
+    QImage mapped = AssetBundle::instance().image(path);
+    if (!mapped.isNull())
+    {
+        _mappedBytes += mapped.sizeInBytes();
+        return _images.insert(path, mapped).value();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QImage decoded = decode(path);
+    if (decoded.isNull())
+    {
+        qWarning() << "Could not decode texture" << path;
+    }
+
+    _decodeTime += timer.elapsed();
+    _residentBytes += decoded.sizeInBytes();
+
+    return _images.insert(path, decoded).value();
+}
+
+QPixmap TextureCache::pixmap(QString const& path)
+{
+    auto it = _pixmaps.constFind(path);
+    if (it != _pixmaps.constEnd())
+    {
+        return it.value();
+    }
+
+    QImage const source = image(path);
+
+    // Pixmaps never share pixels with the mapped bundle, so they make the image resident after all
+    if (AssetBundle::instance().hasImage(path))
+    {
+        _residentBytes += source.sizeInBytes();
+    }
+
+    return _pixmaps.insert(path, QPixmap::fromImage(source)).value();
+}
+
+QPixmap TextureCache::trimmedPixmap(QString const& path, QPoint& offset)
+{
+    QImage const decoded = image(path);
+
+    // Bounds of every pixel with any alpha at all
+    int left = decoded.width();
+    int right = -1;
+    int top = decoded.height();
+    int bottom = -1;
+
+    for (int y = 0; y < decoded.height(); y++)
+    {
+        QRgb const* line = reinterpret_cast<QRgb const*>(decoded.constScanLine(y));
+        for (int x = 0; x < decoded.width(); x++)
+        {
+            if (qAlpha(line[x]) != 0)
+            {
+                left = qMin(left, x);
+                right = qMax(right, x);
+                top = qMin(top, y);
+                bottom = y;
+            }
+        }
+    }
+
+    if (right < left)
+    {
+        offset = QPoint();
+        return QPixmap();
+    }
+
+    QRect const bounds(QPoint(left, top), QPoint(right, bottom));
+    offset = bounds.topLeft();
+
+    // Only the trimmed part is copied into a pixmap, not the whole image
+    return QPixmap::fromImage(decoded.copy(bounds));
+}
+
+QBrush TextureCache::brush(QString const& path)
+{
+    auto it = _brushes.constFind(path);
+    if (it != _brushes.constEnd())
+    {
+        return it.value();
+    }
+
+    return _brushes.insert(path, QBrush(pixmap(path))).value();
+}
+
+void TextureCache::clear()
+{
+    _brushes.clear();
+    _pixmaps.clear();
+    _images.clear();
+
+    _residentBytes = 0;
+    _mappedBytes = 0;
+}
@@ -0,0 +1,124 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <QBrush>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <QString>
+
+#include <functional>
+
+/*!
+ * \brief The TextureCache class decodes every image the game draws once, converted to premultiplied
+ * ARGB, and hands out shared handles to them. Images, pixmaps and brushes are implicitly shared by
+ * Qt, so the copies handed out by the cache never decode or copy pixels again. Images held by the
+ * open AssetBundle are not decoded at all, but viewed where the bundle is mapped, and only copied
+ * into a pixmap once something draws them.
+ */
+class TextureCache
+{
+public:
+    /*!
+     * \brief Returns the cache shared by the whole process.
+     */
+    static TextureCache& instance();
+
+    /*!
+     * \brief Loads every image in the images resource directory that is not loaded yet, decoding
+     * those that are not in the asset bundle spread across every core. Events keep being
+     * processed while the images decode.
+     * \param progress called on the calling thread with the number of images decoded so far
+     * and the number being decoded in total
+     */
+    void preload(std::function<void(int, int)> const& progress = {});
+
+    /*!
+     * \brief Returns a decoded image, viewing it in the asset bundle or decoding it first if it
+     * has not been preloaded.
+     * \param path the resource path of the image, such as ":/images/bullet.png"
+     * \return the image, or a null image if it could not be decoded
+     */
+    QImage image(QString const& path);
+
+    /*!
+     * \brief Returns a pixmap of a decoded image.
+     * \param path the resource path of the image
+     * \return the pixmap
+     */
+    QPixmap pixmap(QString const& path);
+
+    /*!
+     * \brief Returns a pixmap of only the part of a decoded image that is not fully transparent,
+     * so that items drawing it repaint no more of the screen than they cover.
+     * \param path the resource path of the image
+     * \param offset set to where the returned part starts in the whole image
+     * \return the pixmap, or a null pixmap if the whole image is transparent
+     */
+    QPixmap trimmedPixmap(QString const& path, QPoint& offset);
+
+    /*!
+     * \brief Returns a texture brush of a decoded image. Only use brushes for tiling; single
+     * sprites are faster drawn as pixmaps.
+     * \param path the resource path of the image
+     * \return the brush
+     */
+    QBrush brush(QString const& path);
+
+    /*!
+     * \brief Releases every image, pixmap and brush held by the cache. Pixmaps must not
+     * outlive the application object, so this is called when the application is about to quit.
+     */
+    void clear();
+
+    /*!
+     * \brief Returns the number of images decoded so far.
+     */
+    inline int count() const
+    {
+        return _images.size();
+    }
+
+    /*!
+     * \brief Returns the total time (in milliseconds) spent decoding images.
+     */
+    inline qint64 decodeTime() const
+    {
+        return _decodeTime;
+    }
+
+    /*!
+     * \brief Returns the number of bytes of pixels held privately by this process: every
+     * decoded image, and the pixmaps made of images in the asset bundle.
+     */
+    inline qint64 residentBytes() const
+    {
+        return _residentBytes;
+    }
+
+    /*!
+     * \brief Returns the number of bytes of pixels viewed in the asset bundle. Only the images
+     * themselves share these pages with other processes mapping the bundle; a pixmap made of
+     * one is a private copy, and is counted by residentBytes() instead.
+     */
+    inline qint64 mappedBytes() const
+    {
+        return _mappedBytes;
+    }
+
+private:
+    TextureCache() = default;
+    TextureCache(TextureCache const&) = delete;
+    TextureCache& operator=(TextureCache const&) = delete;
+
+    QHash<QString, QImage> _images;
+    QHash<QString, QPixmap> _pixmaps;
+    QHash<QString, QBrush> _brushes;
+
+    qint64 _decodeTime = 0;
+    qint64 _residentBytes = 0;
+    qint64 _mappedBytes = 0;
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,95 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(qint64 tickLength, int slotCount) :
+    _tickLength(qMax<qint64>(1, tickLength)),
+    _slots(qMax(1, slotCount))
+{
+}
+
+void TimerWheel::schedule(quint32 key, qint64 time)
+{
+    cancel(key);
+
+    // Overdue timers go in the next slot to be looked at
+    qint64 tick = qMax(time / _tickLength, _currentTick + 1);
+
+    int slot = slotOf(tick);
+    _slots[slot].append({ key, time });
+    _slotOfKey.insert(key, slot);
+}
+
+void TimerWheel::cancel(quint32 key)
+{
+    auto it = _slotOfKey.find(key);
+    if (it == _slotOfKey.end())
+    {
+        return;
+    }
+
+    removeFromSlot(it.value(), key);
+    _slotOfKey.erase(it);
+}
+
+void TimerWheel::clear()
+{
+    for (QVector<Timer>& slot : _slots)
+    {
+        slot.clear();
+    }
+    _slotOfKey.clear();
+}
+
+void TimerWheel::advance(qint64 time, QVector<quint32>& expired)
+{
+    expired.clear();
+
+    qint64 lastTick = time / _tickLength;
+    if (lastTick <= _currentTick)
+    {
+        return; // time went backwards
+    }
+
+    // Each slot only needs to be looked at once, however far the wheel moves
+    qint64 firstTick = qMax(_currentTick + 1, lastTick - _slots.size() + 1);
+    for (qint64 tick = firstTick; tick <= lastTick; tick++)
+    {
+        QVector<Timer>& slot = _slots[slotOf(tick)];
+        for (int i = 0; i < slot.size(); )
+        {
+            if (slot[i].time > time)
+            {
+                i++;
+                continue;
+            }
+
+            expired.append(slot[i].key);
+            _slotOfKey.remove(slot[i].key);
+
+            // Order within a slot does not matter
+            slot[i] = slot.last();
+            slot.removeLast();
+        }
+    }
+
+    // Timers due later in the last tick are found on a later advance
+    _currentTick = lastTick - 1;
+}
+
+int TimerWheel::slotOf(qint64 tick) const
+{
+    return static_cast<int>(tick % _slots.size());
+}
+
+void TimerWheel::removeFromSlot(int slot, quint32 key)
+{
+    QVector<Timer>& timers = _slots[slot];
+    for (int i = 0; i < timers.size(); i++)
+    {
+        if (timers[i].key == key)
+        {
+            timers[i] = timers.last();
+            timers.removeLast();
+            return;
+        }
+    }
+}
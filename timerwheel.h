@@ -0,0 +1,99 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include "settings.h"
+
+#include <QHash>
+#include <QVector>
+
+/*!
+ * \brief The TimerWheel class keeps any number of timers, each identified by a key, without a
+ * QTimer per timer. Timers are hashed into a ring of slots by their due time, one slot per tick,
+ * so advancing the wheel only looks at the slots of the ticks that have passed instead of at
+ * every timer. Timers due further ahead than one turn of the wheel wait in their slot for as
+ * many turns as needed.
+ */
+class TimerWheel
+{
+public:
+    /*!
+     * \brief Creates an empty wheel at time 0.
+     * \param tickLength the length (in milliseconds) of the time covered by each slot
+     * \param slotCount the number of slots in the ring
+     */
+    explicit TimerWheel(qint64 tickLength = SIMULATION_STEP, int slotCount = TIMER_WHEEL_SLOTS);
+
+    /*!
+     * \brief Schedules a timer, replacing any timer already scheduled with the same key.
+     * Timers due before the current time are due on the next advance.
+     * \param key the key of the timer
+     * \param time the time (in milliseconds) the timer is due
+     */
+    void schedule(quint32 key, qint64 time);
+
+    /*!
+     * \brief Cancels a timer, if it is scheduled.
+     * \param key the key of the timer
+     */
+    void cancel(quint32 key);
+
+    /*!
+     * \brief Cancels every timer.
+     */
+    void clear();
+
+    /*!
+     * \brief Moves the wheel forward, collecting the keys of every timer that has come due.
+     * \param time the current time (in milliseconds)
+     * \param expired cleared, then filled with the keys of the timers that are due, which are
+     * no longer scheduled
+     */
+    void advance(qint64 time, QVector<quint32>& expired);
+
+    /*!
+     * \brief Returns whether a timer is scheduled.
+     * \param key the key of the timer
+     */
+    inline bool isScheduled(quint32 key) const
+    {
+        return _slotOfKey.contains(key);
+    }
+
+    /*!
+     * \brief Returns the number of timers scheduled.
+     */
+    inline int size() const
+    {
+        return _slotOfKey.size();
+    }
+
+private:
+    struct Timer
+    {
+        quint32 key;
+        qint64 time;
+    };
+
+    int slotOf(qint64 tick) const;
+
+    /*!
+     * \brief Removes the timer with the specified key from a slot.
+     */
+    void removeFromSlot(int slot, quint32 key);
+
+    qint64 _tickLength;
+    QVector<QVector<Timer>> _slots;
+
+    /*!
+     * \brief The slot of every scheduled timer, by key
+     */
+    QHash<quint32, int> _slotOfKey;
+
+    /*!
+     * \brief The last tick that has passed entirely. The slot of the tick after it is looked
+     * at again on every advance until that tick has passed too.
+     */
+    qint64 _currentTick = -1;
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,246 @@
+#include "wallfield.h"
+#include "geometry.h"
+
+#include <limits>
+
+WallField::WallField(QRectF const& bounds, qreal resolution)
+    : _bounds(bounds)
+    , _resolution(qMax(resolution, qreal(0.25)))
+    , _tolerance(_resolution * M_SQRT2)
+    , _columns(qCeil(bounds.width() / _resolution) + 1)
+    , _rows(qCeil(bounds.height() / _resolution) + 1)
+    , _bucketColumns(qMax(1, qCeil(bounds.width() / SPATIAL_GRID_CELL_SIZE)))
+    , _bucketRows(qMax(1, qCeil(bounds.height() / SPATIAL_GRID_CELL_SIZE)))
+{
+
+}
+
+void WallField::bake(QVector<QVector<QPointF>> const& walls)
+{
+    _edges.clear();
+    _buckets.clear();
+    _distances.clear();
+
+    for (QVector<QPointF> const& wall : walls)
+    {
+        for (int i = 0, j = wall.size() - 1; i < wall.size(); j = i++)
+        {
+            // Repeated corners make empty edges
+            if (wall[i] != wall[j])
+            {
+                _edges.append({ wall[j], wall[i] });
+            }
+        }
+    }
+
+    if (_edges.isEmpty())
+    {
+        return;
+    }
+
+    // Sort the edges into every bucket their bounding box overlaps
+    _buckets.resize(_bucketColumns * _bucketRows);
+    for (int e = 0; e < _edges.size(); e++)
+    {
+        QRectF box = QRectF(_edges[e].a, _edges[e].b).normalized();
+        int left = qBound(0, static_cast<int>((box.left() - _bounds.left()) / SPATIAL_GRID_CELL_SIZE), _bucketColumns - 1);
+        int top = qBound(0, static_cast<int>((box.top() - _bounds.top()) / SPATIAL_GRID_CELL_SIZE), _bucketRows - 1);
+        int right = qBound(0, static_cast<int>((box.right() - _bounds.left()) / SPATIAL_GRID_CELL_SIZE), _bucketColumns - 1);
+        int bottom = qBound(0, static_cast<int>((box.bottom() - _bounds.top()) / SPATIAL_GRID_CELL_SIZE), _bucketRows - 1);
+
+        for (int row = top; row <= bottom; row++)
+        {
+            for (int column = left; column <= right; column++)
+            {
+                _buckets[row * _bucketColumns + column].append(e);
+            }
+        }
+    }
+
+    // Sample the distance to the nearest edge, negated inside walls
+    _distances.resize(_columns * _rows);
+    for (int row = 0; row < _rows; row++)
+    {
+        for (int column = 0; column < _columns; column++)
+        {
+            QPointF point(_bounds.left() + column * _resolution, _bounds.top() + row * _resolution);
+
+            qreal nearest = std::numeric_limits<qreal>::max();
+            for (Edge const& edge : qAsConst(_edges))
+            {
+                nearest = qMin(nearest, distanceSquaredToSegment(point, edge.a, edge.b));
+            }
+
+            bool inside = false;
+            for (QVector<QPointF> const& wall : walls)
+            {
+                if (polygonContainsPoint(wall, point))
+                {
+                    inside = true;
+                    break;
+                }
+            }
+
+            qreal distance = qSqrt(nearest);
+            _distances[row * _columns + column] = static_cast<float>(inside ? -distance : distance);
+        }
+    }
+}
+
+qreal WallField::distance(QPointF point) const
+{
+    if (_distances.isEmpty())
+    {
+        return std::numeric_limits<qreal>::max();
+    }
+
+    qreal x = qBound(qreal(0), (point.x() - _bounds.left()) / _resolution, qreal(_columns - 1));
+    qreal y = qBound(qreal(0), (point.y() - _bounds.top()) / _resolution, qreal(_rows - 1));
+
+    int column = qMin(static_cast<int>(x), _columns - 2);
+    int row = qMin(static_cast<int>(y), _rows - 2);
+    qreal fx = x - column;
+    qreal fy = y - row;
+
+    float const* top = _distances.constData() + row * _columns + column;
+    float const* bottom = top + _columns;
+
+    qreal upper = top[0] + (top[1] - top[0]) * fx;
+    qreal lower = bottom[0] + (bottom[1] - bottom[0]) * fx;
+    return upper + (lower - upper) * fy;
+}
+
+bool WallField::intersectsCircle(QPointF center, qreal radius) const
+{
+    if (_edges.isEmpty())
+    {
+        return false;
+    }
+
+    qreal d = distance(center);
+
+    // Clearly clear of, or clearly overlapping, every wall
+    if (d > radius + _tolerance)
+    {
+        return false;
+    }
+    if (d < radius - _tolerance)
+    {
+        return true;
+    }
+
+    // Close to an edge from the outside, so only the nearby edges matter
+    return edgeWithin(center, center, radius);
+}
+
+bool WallField::intersectsCapsule(QPointF a, QPointF b, qreal radius) const
+{
+    if (_edges.isEmpty())
+    {
+        return false;
+    }
+
+    qreal d = distance(a);
+    if (d < radius - _tolerance)
+    {
+        return true;
+    }
+
+    // No part of the segment can reach further than its length from its end
+    if (d > radius + qSqrt(lengthSquared(b - a)) + _tolerance)
+    {
+        return false;
+    }
+
+    // A segment that does not touch any edge is either entirely outside or entirely inside
+    //  a wall, and the end it starts at was not deep inside one
+    return edgeWithin(a, b, radius) || distance(b) < 0.0;
+}
+
+bool WallField::sweepCircle(QPointF origin, QPointF direction, qreal length, qreal radius, qreal& hitDistance) const
+{
+    if (_edges.isEmpty())
+    {
+        return false;
+    }
+
+    if (distance(origin) < radius - _tolerance)
+    {
+        hitDistance = 0.0;
+        return true;
+    }
+
+    // Skip ahead through open space: nothing can be hit closer than the distance to the nearest wall
+    qreal travelled = 0.0;
+    for (int i = 0; i < 64 && travelled < length; i++)
+    {
+        qreal clearance = distance(origin + direction * travelled) - radius - _tolerance;
+        if (clearance <= 0.0)
+        {
+            break;
+        }
+        travelled += clearance;
+    }
+
+    if (travelled >= length)
+    {
+        return false;
+    }
+
+    QPointF start = origin + direction * travelled;
+    if (!edgeWithin(start, origin + direction * length, radius))
+    {
+        return false;
+    }
+
+    // Narrow down the first contact, which lies somewhere between here and the end
+    qreal low = travelled;
+    qreal high = length;
+    if (edgeWithin(start, start, radius))
+    {
+        high = travelled;
+    }
+
+    while (high - low > 0.1)
+    {
+        qreal middle = (low + high) / 2;
+        if (edgeWithin(start, origin + direction * middle, radius))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+        }
+    }
+
+    hitDistance = high;
+    return true;
+}
+
+bool WallField::edgeWithin(QPointF a, QPointF b, qreal limit) const
+{
+    QRectF box = QRectF(a, b).normalized().adjusted(-limit, -limit, limit, limit);
+    int left = qBound(0, static_cast<int>((box.left() - _bounds.left()) / SPATIAL_GRID_CELL_SIZE), _bucketColumns - 1);
+    int top = qBound(0, static_cast<int>((box.top() - _bounds.top()) / SPATIAL_GRID_CELL_SIZE), _bucketRows - 1);
+    int right = qBound(0, static_cast<int>((box.right() - _bounds.left()) / SPATIAL_GRID_CELL_SIZE), _bucketColumns - 1);
+    int bottom = qBound(0, static_cast<int>((box.bottom() - _bounds.top()) / SPATIAL_GRID_CELL_SIZE), _bucketRows - 1);
+
+    qreal limitSquared = limit * limit;
+    for (int row = top; row <= bottom; row++)
+    {
+        for (int column = left; column <= right; column++)
+        {
+            for (int e : _buckets[row * _bucketColumns + column])
+            {
+                Edge const& edge = _edges[e];
+                if (distanceSquaredBetweenSegments(a, b, edge.a, edge.b) < limitSquared)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
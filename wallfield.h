@@ -0,0 +1,115 @@
+#ifndef WALLFIELD_H
+#define WALLFIELD_H
+
+#include "settings.h"
+
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/*!
+ * \brief The WallField class answers collision queries against the static walls of a map. When
+ * the map is loaded, it samples the signed distance to the nearest wall on a fine grid (negative
+ * inside walls), and sorts the wall edges into buckets. Most queries are then answered by a
+ * handful of samples; only shapes right at the edge of a wall are tested against the nearby edges.
+ */
+class WallField
+{
+public:
+    /*!
+     * \brief Creates an empty field covering the specified area.
+     * \param bounds the area covered by the field, in scene coordinates
+     * \param resolution the spacing of the distance samples
+     */
+    explicit WallField(QRectF const& bounds = QRectF(0, 0, MAP_WIDTH, MAP_HEIGHT),
+                       qreal resolution = WALL_FIELD_RESOLUTION);
+
+    /*!
+     * \brief Precomputes the field for the specified walls, replacing any previous walls.
+     * \param walls the corners of each wall, in scene coordinates
+     */
+    void bake(QVector<QVector<QPointF>> const& walls);
+
+    /*!
+     * \brief Returns the approximate distance from a point to the nearest wall, interpolated
+     * between the nearest samples. The distance is negative inside walls.
+     * \param point the point, in scene coordinates
+     * \return the distance in pixels, which is off by at most about one sample spacing
+     */
+    qreal distance(QPointF point) const;
+
+    /*!
+     * \brief Returns whether a circle touches any wall.
+     * \param center the center of the circle
+     * \param radius the radius of the circle
+     * \return true or false
+     */
+    bool intersectsCircle(QPointF center, qreal radius) const;
+
+    /*!
+     * \brief Returns whether a line segment with rounded ends and the specified thickness
+     * touches any wall.
+     * \param a one end of the segment
+     * \param b the other end of the segment
+     * \param radius half the thickness of the segment
+     * \return true or false
+     */
+    bool intersectsCapsule(QPointF a, QPointF b, qreal radius) const;
+
+    /*!
+     * \brief Moves a circle along a straight line and finds where it first touches a wall.
+     * \param origin where the center of the circle starts
+     * \param direction the unit vector the circle moves along
+     * \param length how far the circle moves
+     * \param radius the radius of the circle
+     * \param hitDistance set to how far the circle moved before touching a wall, to within
+     * a tenth of a pixel
+     * \return whether the circle touches a wall on the way
+     */
+    bool sweepCircle(QPointF origin, QPointF direction, qreal length, qreal radius, qreal& hitDistance) const;
+
+    inline bool isEmpty() const
+    {
+        return _edges.isEmpty();
+    }
+
+private:
+    struct Edge
+    {
+        QPointF a;
+        QPointF b;
+    };
+
+    /*!
+     * \brief Returns whether any edge comes closer to a segment than the limit, only looking
+     * at the edges in the buckets around the segment.
+     */
+    bool edgeWithin(QPointF a, QPointF b, qreal limit) const;
+
+    QRectF _bounds;
+    qreal _resolution;
+
+    /*!
+     * \brief The largest error of an interpolated distance
+     */
+    qreal _tolerance;
+
+    int _columns;
+    int _rows;
+
+    /*!
+     * \brief The signed distance at each sample point, row by row
+     */
+    QVector<float> _distances;
+
+    QVector<Edge> _edges;
+
+    /*!
+     * \brief Indices of the edges passing through each bucket, row by row
+     */
+    QVector<QVector<int>> _buckets;
+    int _bucketColumns;
+    int _bucketRows;
+};
+
+#endif // WALLFIELD_H
@@ -20,5 +20,5 @@ WallItem::WallItem(QPointF points[], int numPoints, QPen pen, QBrush brush, QGra
 
 WallItem::~WallItem()
 {
-    delete this;
+
 }
@@ -0,0 +1,281 @@
+#include "worldsnapshot.h"
+#include "settings.h"
+
+#include <QPair>
+
+namespace
+{
+    const quint8 FLAG_HAS_CROWN = 1;
+    const quint8 FLAG_IS_DEAD = 1 << 1;
+
+    // Bitmask of the fields present in a delta player entry
+    const quint8 CHANGED_POSITION = 1;
+    const quint8 CHANGED_VELOCITY = 1 << 1;
+    const quint8 CHANGED_HEALTH = 1 << 2;
+    const quint8 CHANGED_FLAGS = 1 << 3;
+    const quint8 PLAYER_REMOVED = 1 << 4;
+    const quint8 CHANGED_INPUT = 1 << 5;
+    const quint8 CHANGED_ALL = CHANGED_POSITION | CHANGED_VELOCITY | CHANGED_HEALTH | CHANGED_FLAGS | CHANGED_INPUT;
+
+    qint16 quantize(qreal coordinate)
+    {
+        return static_cast<qint16>(qBound(-32768.0, qRound(coordinate * SNAPSHOT_POSITION_SCALE) * 1.0, 32767.0));
+    }
+
+    qreal unquantize(qint16 coordinate)
+    {
+        return static_cast<qreal>(coordinate) / SNAPSHOT_POSITION_SCALE;
+    }
+
+    qint16 quantizeVelocity(qreal component)
+    {
+        return static_cast<qint16>(qBound(-32768.0, qRound(component) * 1.0, 32767.0));
+    }
+
+    quint8 flagsOf(PlayerSnapshot const& player)
+    {
+        return (player.hasCrown ? FLAG_HAS_CROWN : 0)
+               | (player.isDead ? FLAG_IS_DEAD : 0);
+    }
+
+    quint8 changesBetween(PlayerSnapshot const& player, PlayerSnapshot const& baseline)
+    {
+        quint8 mask = 0;
+
+        if (quantize(player.position.x()) != quantize(baseline.position.x())
+            || quantize(player.position.y()) != quantize(baseline.position.y()))
+        {
+            mask |= CHANGED_POSITION;
+        }
+
+        if (quantizeVelocity(player.velocity.x()) != quantizeVelocity(baseline.velocity.x())
+            || quantizeVelocity(player.velocity.y()) != quantizeVelocity(baseline.velocity.y()))
+        {
+            mask |= CHANGED_VELOCITY;
+        }
+
+        if (player.health != baseline.health)
+        {
+            mask |= CHANGED_HEALTH;
+        }
+
+        if (flagsOf(player) != flagsOf(baseline))
+        {
+            mask |= CHANGED_FLAGS;
+        }
+
+        if (player.lastInput != baseline.lastInput)
+        {
+            mask |= CHANGED_INPUT;
+        }
+
+        return mask;
+    }
+
+    void writePlayerFields(BinaryWriter& writer, PlayerSnapshot const& player, quint8 mask)
+    {
+        if (mask & CHANGED_POSITION)
+        {
+            writer.writeInt16(quantize(player.position.x()));
+            writer.writeInt16(quantize(player.position.y()));
+        }
+
+        if (mask & CHANGED_VELOCITY)
+        {
+            writer.writeInt16(quantizeVelocity(player.velocity.x()));
+            writer.writeInt16(quantizeVelocity(player.velocity.y()));
+        }
+
+        if (mask & CHANGED_HEALTH)
+        {
+            writer.writeInt16(static_cast<qint16>(player.health));
+        }
+
+        if (mask & CHANGED_FLAGS)
+        {
+            writer.writeUInt8(flagsOf(player));
+        }
+
+        if (mask & CHANGED_INPUT)
+        {
+            writer.writeUInt32(player.lastInput);
+        }
+    }
+
+    void readPlayerFields(BinaryReader& reader, PlayerSnapshot& player, quint8 mask)
+    {
+        if (mask & CHANGED_POSITION)
+        {
+            player.position.setX(unquantize(reader.readInt16()));
+            player.position.setY(unquantize(reader.readInt16()));
+        }
+
+        if (mask & CHANGED_VELOCITY)
+        {
+            player.velocity.setX(reader.readInt16());
+            player.velocity.setY(reader.readInt16());
+        }
+
+        if (mask & CHANGED_HEALTH)
+        {
+            player.health = reader.readInt16();
+        }
+
+        if (mask & CHANGED_FLAGS)
+        {
+            quint8 flags = reader.readUInt8();
+            player.hasCrown = flags & FLAG_HAS_CROWN;
+            player.isDead = flags & FLAG_IS_DEAD;
+        }
+
+        if (mask & CHANGED_INPUT)
+        {
+            player.lastInput = reader.readUInt32();
+        }
+    }
+}
+
+PlayerSnapshot* WorldSnapshot::player(PlayerColor color)
+{
+    for (PlayerSnapshot& player : players)
+    {
+        if (player.color == color)
+        {
+            return &player;
+        }
+    }
+
+    return nullptr;
+}
+
+PlayerSnapshot const* WorldSnapshot::player(PlayerColor color) const
+{
+    for (PlayerSnapshot const& player : players)
+    {
+        if (player.color == color)
+        {
+            return &player;
+        }
+    }
+
+    return nullptr;
+}
+
+PlayerSnapshot const* WorldSnapshot::crownHolder() const
+{
+    for (PlayerSnapshot const& player : players)
+    {
+        if (player.hasCrown)
+        {
+            return &player;
+        }
+    }
+
+    return nullptr;
+}
+
+void WorldSnapshot::write(BinaryWriter& writer) const
+{
+    writer.writeUInt32(tick);
+    writer.writeUInt32(time);
+
+    writer.writeUInt8(static_cast<quint8>(players.size()));
+    for (PlayerSnapshot const& player : players)
+    {
+        writer.writeUInt8(static_cast<quint8>(player.color));
+        writePlayerFields(writer, player, CHANGED_ALL);
+    }
+}
+
+bool WorldSnapshot::read(BinaryReader& reader)
+{
+    tick = reader.readUInt32();
+    time = reader.readUInt32();
+
+    int playerCount = reader.readUInt8();
+    players.resize(playerCount);
+    for (PlayerSnapshot& player : players)
+    {
+        player.color = static_cast<PlayerColor>(reader.readUInt8());
+        readPlayerFields(reader, player, CHANGED_ALL);
+    }
+
+    return reader.ok();
+}
+
+void WorldSnapshot::writeDelta(BinaryWriter& writer, WorldSnapshot const& baseline) const
+{
+    writer.writeUInt32(tick);
+    writer.writeUInt32(time);
+
+    // Collect the player entries first, since their count precedes them
+    QVector<QPair<PlayerSnapshot const*, quint8>> entries;
+
+    for (PlayerSnapshot const& player : players)
+    {
+        PlayerSnapshot const* previous = baseline.player(player.color);
+        quint8 mask = previous ? changesBetween(player, *previous) : CHANGED_ALL;
+
+        if (mask != 0)
+        {
+            entries.append(qMakePair(&player, mask));
+        }
+    }
+
+    for (PlayerSnapshot const& previous : baseline.players)
+    {
+        if (player(previous.color) == nullptr)
+        {
+            entries.append(qMakePair(&previous, PLAYER_REMOVED));
+        }
+    }
+
+    writer.writeUInt8(static_cast<quint8>(entries.size()));
+    for (auto const& entry : entries)
+    {
+        writer.writeUInt8(static_cast<quint8>(entry.first->color));
+        writer.writeUInt8(entry.second);
+        writePlayerFields(writer, *entry.first, entry.second);
+    }
+}
+
+bool WorldSnapshot::readDelta(BinaryReader& reader, WorldSnapshot const& baseline)
+{
+    *this = baseline;
+
+    tick = reader.readUInt32();
+    time = reader.readUInt32();
+
+    int entryCount = reader.readUInt8();
+    for (int i = 0; i < entryCount && reader.ok(); i++)
+    {
+        PlayerColor color = static_cast<PlayerColor>(reader.readUInt8());
+        quint8 mask = reader.readUInt8();
+
+        if (mask & PLAYER_REMOVED)
+        {
+            for (int j = 0; j < players.size(); j++)
+            {
+                if (players[j].color == color)
+                {
+                    players.remove(j);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        PlayerSnapshot* existing = player(color);
+        if (existing == nullptr)
+        {
+            PlayerSnapshot added;
+            added.color = color;
+            players.append(added);
+            existing = &players.last();
+        }
+
+        readPlayerFields(reader, *existing, mask);
+    }
+
+    return reader.ok();
+}
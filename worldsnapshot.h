@@ -0,0 +1,103 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include "binarystream.h"
+#include "playercolor.h"
+
+#include <QPointF>
+#include <QVector>
+
+/*!
+ * \brief The PlayerSnapshot struct holds the state of a single player at one server tick.
+ */
+struct PlayerSnapshot
+{
+    PlayerColor color = PlayerColor::Red;
+
+    /*!
+     * \brief The position of the player, in scene coordinates.
+     */
+    QPointF position;
+
+    /*!
+     * \brief The velocity of the player, in pixels per second.
+     */
+    QPointF velocity;
+
+    int health = 0;
+    bool hasCrown = false;
+    bool isDead = false;
+
+    /*!
+     * \brief The sequence number of the player's latest input that the host has applied,
+     * so the player's own client knows which of its predictions this state reflects.
+     */
+    quint32 lastInput = 0;
+};
+
+/*!
+ * \brief The WorldSnapshot struct holds the complete state of the game world that the host
+ * sends to every client at a fixed rate. Bullets are not part of it: every bullet is announced
+ * once, reliably, when it is fired, and clients simulate it from there.
+ */
+struct WorldSnapshot
+{
+    /*!
+     * \brief The server tick at which this snapshot was taken. Tick 0 is never sent,
+     * so it can be used to mean "no snapshot".
+     */
+    quint32 tick = 0;
+
+    /*!
+     * \brief The server time (in milliseconds) at which this snapshot was taken.
+     */
+    quint32 time = 0;
+
+    QVector<PlayerSnapshot> players;
+
+    /*!
+     * \brief Returns the player with the specified color.
+     * \param color the color of the player to find
+     * \return the player, or nullptr if the player is not part of this snapshot
+     */
+    PlayerSnapshot* player(PlayerColor color);
+    PlayerSnapshot const* player(PlayerColor color) const;
+
+    /*!
+     * \brief Returns the player who currently holds the crown.
+     * \return the crown holder, or nullptr if nobody has the crown
+     */
+    PlayerSnapshot const* crownHolder() const;
+
+    /*!
+     * \brief Writes the full snapshot in the fixed binary layout of the wire protocol.
+     * \param writer the writer to write the snapshot to
+     */
+    void write(BinaryWriter& writer) const;
+
+    /*!
+     * \brief Reads a full snapshot that was written with write().
+     * \param reader the reader to read the snapshot from
+     * \return whether or not the snapshot was able to be read
+     */
+    bool read(BinaryReader& reader);
+
+    /*!
+     * \brief Writes only what has changed since the specified baseline snapshot. Each player
+     * entry starts with a bitmask of the fields that follow; players that did not change are
+     * left out entirely.
+     * \param writer the writer to write the delta to
+     * \param baseline the snapshot the receiver already has
+     */
+    void writeDelta(BinaryWriter& writer, WorldSnapshot const& baseline) const;
+
+    /*!
+     * \brief Reads a delta that was written with writeDelta() and applies it to the baseline.
+     * \param reader the reader to read the delta from
+     * \param baseline the snapshot the delta was written against
+     * \return whether or not the delta was able to be read
+     */
+    bool readDelta(BinaryReader& reader, WorldSnapshot const& baseline);
+};
+
+#endif // WORLDSNAPSHOT_H